@@ -1,8 +1,11 @@
 #include <qpdf/Pl_ASCII85Decoder.hh>
-#include <qpdf/Pl_Discard.hh>
+#include <qpdf/Pl_String.hh>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
+using namespace std::literals;
+
 class FuzzHelper
 {
   public:
@@ -12,16 +15,38 @@ class FuzzHelper
     {
     }
 
-    void
-    run()
+    // Decode the data passing it to the decoder in chunks of the given size. Return the output
+    // followed by the error message if any.
+    std::string
+    decode(size_t chunk)
     {
-        Pl_Discard discard;
-        Pl_ASCII85Decoder p("decode", &discard);
+        std::string out;
+        Pl_String result("result", nullptr, out);
+        Pl_ASCII85Decoder p("decode", &result);
         try {
-            p.write(data, size);
+            for (size_t i = 0; i < size; i += chunk) {
+                p.write(data + i, std::min(chunk, size - i));
+            }
             p.finish();
         } catch (std::runtime_error const& e) {
-            std::cerr << "runtime_error: " << e.what() << '\n';
+            out += "\nruntime_error: "s + e.what();
+        }
+        return out;
+    }
+
+    void
+    run()
+    {
+        // Complete input is decoded in bulk where possible. Compare with the result of decoding
+        // one byte at a time and in chunks that are not aligned with groups of the encoding.
+        auto result = decode(std::max(size, size_t(1)));
+        if (auto at = result.find("\nruntime_error: "); at != std::string::npos) {
+            std::cerr << result.substr(at + 1) << '\n';
+        }
+        for (size_t chunk: {1U, 7U}) {
+            if (decode(chunk) != result) {
+                throw std::logic_error("results differ when writing in chunks");
+            }
         }
     }
 
@@ -0,0 +1,58 @@
+#include <qpdf/Pl_Base64.hh>
+#include <stdexcept>
+#include <string>
+
+using namespace std::literals;
+
+class FuzzHelper
+{
+  public:
+    FuzzHelper(unsigned char const* data, size_t size) :
+        data(data),
+        size(size)
+    {
+    }
+
+    // Return the decoded data or the error message.
+    static std::string
+    decode(std::string const& encoded)
+    {
+        try {
+            return Pl_Base64::decode(encoded);
+        } catch (std::runtime_error const& e) {
+            return "runtime_error: "s + e.what();
+        }
+    }
+
+    void
+    run()
+    {
+        std::string input(reinterpret_cast<char const*>(data), size);
+        // Groups of four characters without white space are decoded in bulk. White space is
+        // otherwise ignored, so adding a space after each character must not change the result.
+        auto result = decode(input);
+        std::string spaced;
+        for (auto ch: input) {
+            spaced += ch;
+            spaced += ' ';
+        }
+        if (decode(spaced) != result) {
+            throw std::logic_error("results differ when decoding with white space");
+        }
+        if (Pl_Base64::decode(Pl_Base64::encode(input)) != input) {
+            throw std::logic_error("encoding and decoding does not reproduce the input");
+        }
+    }
+
+  private:
+    unsigned char const* data;
+    size_t size;
+};
+
+extern "C" int
+LLVMFuzzerTestOneInput(unsigned char const* data, size_t size)
+{
+    FuzzHelper f(data, size);
+    f.run();
+    return 0;
+}
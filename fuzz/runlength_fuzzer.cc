@@ -1,10 +1,13 @@
-#include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_RunLength.hh>
+#include <qpdf/Pl_String.hh>
 #include <qpdf/global.hh>
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
+using namespace std::literals;
+
 class FuzzHelper
 {
   public:
@@ -14,18 +17,44 @@ class FuzzHelper
     {
     }
 
+    // Decode the data passing it to the decoder in chunks of the given size. Return the output
+    // followed by the error message if any.
+    std::string
+    decode(size_t chunk)
+    {
+        std::string out;
+        Pl_String result("result", nullptr, out);
+        Pl_RunLength p("decode", &result, Pl_RunLength::a_decode);
+        try {
+            for (size_t i = 0; i < size; i += chunk) {
+                p.write(data + i, std::min(chunk, size - i));
+            }
+            p.finish();
+        } catch (std::runtime_error const& e) {
+            out += "\nruntime_error: "s + e.what();
+        }
+        return out;
+    }
+
     void
     run()
     {
         qpdf::global::options::fuzz_mode(true);
 
-        Pl_Discard discard;
-        Pl_RunLength p("decode", &discard, Pl_RunLength::a_decode);
-        try {
-            p.write(data, size);
-            p.finish();
-        } catch (std::runtime_error const& e) {
-            std::cerr << "runtime_error: " << e.what() << '\n';
+        // Complete input is decoded in bulk where possible. Compare with the result of decoding
+        // one byte at a time and in chunks that are not aligned with groups of the encoding.
+        auto result = decode(std::max(size, size_t(1)));
+        if (auto at = result.find("\nruntime_error: "); at != std::string::npos) {
+            std::cerr << result.substr(at + 1) << '\n';
+        }
+        for (size_t chunk: {1U, 7U}) {
+            auto other = decode(chunk);
+            // The memory limit is checked when data is written, so it may be reached at different
+            // points depending on how the data is split.
+            if (other != result && result.find("memory limit") == std::string::npos &&
+                other.find("memory limit") == std::string::npos) {
+                throw std::logic_error("results differ when writing in chunks");
+            }
         }
     }
 
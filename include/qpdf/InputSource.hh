@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <string_view>
 
 // Remember to use QPDF_DLL_CLASS on anything derived from InputSource so it will work with
 // dynamic_cast across the shared object boundary.
@@ -82,6 +83,8 @@ class QPDF_DLL_CLASS InputSource
     std::string read_line(size_t count, qpdf_offset_t at = -1);
     inline qpdf_offset_t fastTell();
     inline bool fastRead(char&);
+    inline std::string_view fastPeek();
+    inline void fastSkip(size_t);
     inline void fastUnread(bool);
     inline void loadBuffer();
 
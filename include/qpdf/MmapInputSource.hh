@@ -0,0 +1,75 @@
+// Copyright (c) 2005-2021 Jay Berkenbilt
+// Copyright (c) 2022-2026 Jay Berkenbilt and Manfred Holger
+//
+// This file is part of qpdf.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under
+// the License.
+//
+// Versions of qpdf prior to version 7 were released under the terms of version 2.0 of the Artistic
+// License. At your option, you may continue to consider qpdf to be licensed under those terms.
+
+#ifndef QPDF_MMAPINPUTSOURCE_HH
+#define QPDF_MMAPINPUTSOURCE_HH
+
+#include <qpdf/InputSource.hh>
+
+#include <memory>
+#include <string_view>
+
+// MmapInputSource maps a file into memory read-only and serves all reads directly from the mapping.
+// This avoids the system call and copying overhead of stdio for files that are read with many
+// seeks, which is typical when parsing large PDF files. The file must not be modified or truncated
+// while the input source exists. If memory mapped files are not supported on the current platform,
+// the constructor throws std::runtime_error. Added in qpdf 12.4.
+class QPDF_DLL_CLASS MmapInputSource: public InputSource
+{
+  public:
+    QPDF_DLL
+    MmapInputSource(char const* filename);
+
+    MmapInputSource(MmapInputSource const&) = delete;
+    MmapInputSource& operator=(MmapInputSource const&) = delete;
+
+    QPDF_DLL
+    ~MmapInputSource() override;
+
+    // Return true if memory mapped files are supported on this platform.
+    QPDF_DLL
+    static bool supported();
+
+    QPDF_DLL
+    qpdf_offset_t findAndSkipNextEOL() override;
+    QPDF_DLL
+    std::string const& getName() const override;
+    QPDF_DLL
+    qpdf_offset_t tell() override;
+    QPDF_DLL
+    void seek(qpdf_offset_t offset, int whence) override;
+    QPDF_DLL
+    void rewind() override;
+    QPDF_DLL
+    size_t read(char* buffer, size_t length) override;
+    QPDF_DLL
+    void unreadCh(char ch) override;
+
+    // Return a view of up to length bytes starting at offset without copying. The view remains
+    // valid for the lifetime of the input source. Like read, this sets the last offset and
+    // advances the current position.
+    QPDF_DLL
+    std::string_view view(qpdf_offset_t offset, size_t length);
+
+  private:
+    class Members;
+
+    std::unique_ptr<Members> m;
+};
+
+#endif // QPDF_MMAPINPUTSOURCE_HH
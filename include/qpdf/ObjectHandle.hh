@@ -86,6 +86,11 @@ namespace qpdf
         QPDFObjectHandle operator[](size_t n) const;
         QPDFObjectHandle operator[](int n) const;
 
+        // References returned by at, find and operator[] for dictionary keys point into the
+        // dictionary's storage. Like iterators over the dictionary, they remain valid only until a
+        // key is added to or removed from the same dictionary (including by at adding a missing
+        // key) or the dictionary is released from the object cache. Copy the value into a
+        // QPDFObjectHandle if the dictionary may change while it is in use.
         QPDFObjectHandle& at(std::string const& key) const;
         bool contains(std::string const& key) const;
         size_t erase(std::string const& key);
@@ -136,6 +141,8 @@ namespace qpdf
         inline void assign(qpdf_object_type_e required, BaseHandle const& other);
         inline void assign(qpdf_object_type_e required, BaseHandle&& other);
         inline void nullify();
+        inline void mark_modified() const;
+        inline void mark_exposed() const;
 
         std::string description() const;
         inline QPDFObjectHandle const& get(std::string const& key) const;
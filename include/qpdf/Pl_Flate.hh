@@ -66,6 +66,57 @@ class QPDF_DLL_CLASS Pl_Flate: public Pipeline
     QPDF_DLL
     static void setCompressionLevel(int);
 
+    // Globally set the size in bytes at or above which data is deflated as a sequence of
+    // independently compressed blocks of block_size bytes, as is done by pigz. Each block is primed
+    // with the last 32 KiB of the preceding block, and the blocks are concatenated into a single
+    // zlib stream, so the result is usually only slightly larger than with regular compression.
+    // Since the blocks are independent of each other, they can be compressed in parallel; see
+    // setJobs. Input is buffered until the threshold is reached. The output depends only on the
+    // input, the threshold, and the compression level, not on the number of jobs. The default is 0,
+    // which disables block compression. Added in qpdf 12.4.
+    QPDF_DLL
+    static void setBlockThreshold(size_t);
+
+    // Return the value set with setBlockThreshold. Added in qpdf 12.4.
+    QPDF_DLL
+    static size_t getBlockThreshold();
+
+    // The size in bytes of the blocks into which data is split when deflating in blocks (see
+    // setBlockThreshold). Only the last block may be smaller. Added in qpdf 12.4.
+    static size_t const block_size = 1 << 20;
+
+    // When deflating in blocks (see setBlockThreshold), compress up to the given number of blocks
+    // at the same time in worker threads. The default is 1. Added in qpdf 12.4.
+    QPDF_DLL
+    void setJobs(int);
+
+    // Implementations of flate compression. zlib is always available. When qpdf is built with the
+    // LIBDEFLATE build option, libdeflate, which is considerably faster than zlib, can be used
+    // instead. libdeflate only compresses and uncompresses complete buffers, so with b_libdeflate,
+    // Pl_Flate buffers its input and processes it when finish() is called. When inflating, this is
+    // only done for up to 1 MiB of input; larger input is inflated by zlib as it is written. Data
+    // that libdeflate can't uncompress completely, such as damaged streams, is passed to zlib so
+    // that the results and warnings are the same as with b_zlib. Zopfli and block compression (see
+    // setBlockThreshold) take precedence over libdeflate for compression. Added in qpdf 12.4.
+    enum backend_e { b_zlib, b_libdeflate };
+
+    // Returns true if qpdf was built with support for the given backend. Added in qpdf 12.4.
+    QPDF_DLL
+    static bool backend_supported(backend_e);
+
+    // Globally select the backend for Pl_Flate instances created after the call. The default is
+    // b_zlib. Throws std::runtime_error if the backend is not supported. Added in qpdf 12.4.
+    QPDF_DLL
+    static void setBackend(backend_e);
+
+    // Return a string that describes the global settings that affect the output of deflating,
+    // including the compression level, the block threshold, the backend, and the zlib version. Data
+    // deflated by two Pl_Flate instances is identical if the input and the compression settings
+    // are the same, so this can be used as part of the key for caching compressed data. Added in
+    // qpdf 12.4.
+    QPDF_DLL
+    static std::string compression_settings();
+
     QPDF_DLL
     void setWarnCallback(std::function<void(char const*, int)> callback);
 
@@ -95,9 +146,19 @@ class QPDF_DLL_CLASS Pl_Flate: public Pipeline
     void warn(char const*, int error_code);
     QPDF_DLL_PRIVATE
     void finish_zopfli();
+    QPDF_DLL_PRIVATE
+    void finish_blocks();
+    QPDF_DLL_PRIVATE
+    void finish_libdeflate();
 
     QPDF_DLL_PRIVATE
     static int compression_level;
+    QPDF_DLL_PRIVATE
+    static size_t block_threshold;
+    QPDF_DLL_PRIVATE
+    static backend_e backend;
+
+    class Blocks;
 
     class QPDF_DLL_PRIVATE Members
     {
@@ -118,6 +179,8 @@ class QPDF_DLL_CLASS Pl_Flate: public Pipeline
         unsigned long long written{0};
         std::function<void(char const*, int)> callback;
         std::unique_ptr<std::string> zopfli_buf;
+        std::unique_ptr<Blocks> blocks;
+        std::unique_ptr<std::string> libdeflate_buf;
     };
 
     std::unique_ptr<Members> m;
@@ -83,6 +83,15 @@ class QPDF
     void processFile(
         char const* description, FILE* file, bool close_file, char const* password = nullptr);
 
+    // Parse a PDF file by mapping it into memory with MmapInputSource. This works exactly like
+    // processFile except that the file is read through a read-only memory mapping, and stream data
+    // is passed to pipelines directly from the mapping without an intermediate copy. The file must
+    // not be modified while the QPDF object exists. Throws std::runtime_error if memory mapped
+    // files are not supported on this platform; see MmapInputSource::supported(). Added in qpdf
+    // 12.4.
+    QPDF_DLL
+    void processMappedFile(char const* filename, char const* password = nullptr);
+
     // Parse a PDF file loaded into a memory buffer.  This works exactly like processFile except
     // that the PDF file is in memory instead of on disk.  The description appears in any warning or
     // error message in place of the file name. The buffer is owned by the caller and must remain
@@ -382,6 +391,57 @@ class QPDF
     QPDF_DLL
     QPDFObjectHandle getObjectByID(int objid, int generation);
 
+    // By default, every object that is read from the input file stays in memory for the lifetime
+    // of the QPDF object. Calling setObjectCacheLimit with a non-zero value bounds the number of
+    // objects read from the input file that are kept in memory. Objects that have not been
+    // modified and into whose values no object handles are held are discarded, least recently
+    // used first, and read again from the input file when next accessed. Existing handles to the
+    // discarded indirect objects remain valid. Objects read with warnings are never discarded so
+    // that warnings are not repeated. Objects are only discarded when trimObjectCache is called
+    // and while QPDFWriter writes a file that is not linearized. Do not call trimObjectCache while
+    // holding references (as opposed to object handles) into the values of objects, for example
+    // while iterating over the items of a dictionary. A limit of 0 removes the limit. Added in
+    // qpdf 12.4.
+    QPDF_DLL
+    void setObjectCacheLimit(size_t);
+    QPDF_DLL
+    void trimObjectCache();
+
+    // Counters for the object cache. hits counts requests for indirect objects that were already
+    // in memory, misses counts indirect objects that had to be read from the input file, including
+    // objects that are read again after having been discarded, and evictions counts objects that
+    // were discarded to stay within the limit set with setObjectCacheLimit. Added in qpdf 12.4.
+    struct ObjectCacheStats
+    {
+        size_t hits{0};
+        size_t misses{0};
+        size_t evictions{0};
+    };
+    QPDF_DLL
+    ObjectCacheStats getObjectCacheStats() const;
+
+    // By default, the first time any object in an object stream is accessed, all objects in the
+    // object stream are parsed. Calling setObjectStreamCacheLimit with a non-zero value instead
+    // parses only the objects that are accessed. The decoded data of up to that many object
+    // streams, together with their tables of object offsets, is kept in memory so that accessing
+    // further objects from a recently used object stream does not require decoding it again. This
+    // makes operations that only look at a few objects, such as getting the number of pages, much
+    // faster for files with large object streams. Warnings about objects in object streams are only
+    // issued once the objects are accessed. A limit of 0 restores the default behavior. Added in
+    // qpdf 12.4.
+    QPDF_DLL
+    void setObjectStreamCacheLimit(size_t);
+
+    // Allocate the objects read from the input file from an arena owned by this QPDF object rather
+    // than individually from the heap. This makes reading and destroying files with many objects
+    // faster and avoids fragmenting the heap in long-running processes. Memory freed by discarded
+    // objects is reused for new objects but is only returned to the heap once the QPDF object and
+    // all object handles obtained from it have been destroyed. The arena is not thread-safe, so
+    // object handles obtained from the QPDF object must not be destroyed by different threads at
+    // the same time. Call this before processing the input file. Added in qpdf 12.4.
+    QPDF_DLL
+    void setObjectArena(bool);
+
     // Replace the object with the given object id with the given object. The object handle passed
     // in must be a direct object, though it may contain references to other indirect objects within
     // it. Prior to qpdf 10.2.1, after calling this method, existing QPDFObjectHandle instances that
@@ -641,6 +701,26 @@ class QPDF
     QPDF_DLL
     void showLinearizationData();
 
+    // If the file is linearized and its hint tables can be used to find pages, return the number
+    // of pages given in the linearization parameter dictionary. Otherwise, return 0. This does not
+    // traverse the pages tree. Added in qpdf 12.4.
+    QPDF_DLL
+    size_t getLinearizedPageCount();
+
+    // Use the linearization hint tables to find the page object for the page with the given
+    // zero-based index without traversing the pages tree or reading the objects of other pages.
+    // This makes the time needed to get to a page of a linearized file independent of the number
+    // of pages. The page is checked against the cross-reference table and its ancestors in the
+    // pages tree. Return a null object if the file is not linearized, if the hint tables don't
+    // match the file, or if the page inherits attributes such as /Resources or /MediaBox from the
+    // pages tree; in that case, use getAllPages instead. The hint tables describe the file as it
+    // was read, so don't call this after adding, removing, or reordering pages. Once a page has been
+    // found this way, QPDFObjectHandle::isPageObject and isPagesObject only check /Type for objects
+    // of this QPDF and no longer read the pages tree to repair missing /Type keys, so copying pages
+    // to another file doesn't read the pages tree either. Added in qpdf 12.4.
+    QPDF_DLL
+    QPDFObjectHandle getLinearizedPage(size_t pageno);
+
     // Shows the contents of the cross-reference table
     QPDF_DLL
     void showXRefTable();
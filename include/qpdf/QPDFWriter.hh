@@ -41,6 +41,7 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace qpdf
@@ -403,6 +404,14 @@ class QPDFWriter
     QPDF_DLL
     void setLinearizationPass1Filename(std::string const&);
 
+    // To linearize, QPDF writes out the file in two passes. The stream data is only encoded once,
+    // before the first pass, and kept for both passes. Encoded stream data beyond the given number
+    // of bytes is kept in a temporary file instead of in memory. The default is 256 MiB. If a
+    // temporary file can't be created, stream data that doesn't fit is encoded again in each
+    // pass. Added in qpdf 12.4.
+    QPDF_DLL
+    void setLinearizationMemoryLimit(size_t);
+
     // Create PCLm output. This is only useful for clients that know how to create PCLm files. If a
     // file is structured exactly as PCLm requires, this call will tell QPDFWriter to write the PCLm
     // header, create certain unreferenced streams required by the standard, and write the objects
@@ -411,6 +420,95 @@ class QPDFWriter
     QPDF_DLL
     void setPCLm(bool);
 
+    // Write an incremental update instead of a complete file. The output consists of the bytes of
+    // the input file, copied unchanged, followed by the objects that have been created or modified
+    // since the file was read, a cross-reference section in the same format as that of the input
+    // file whose /Prev entry points to the last cross-reference section of the input file, and a
+    // new trailer. Only the changed objects are read and written, so the time taken by small
+    // changes to large files depends mostly on the time it takes to copy the input file. Object
+    // numbers are not changed. Most other settings, including object stream and content
+    // normalization settings, do not apply to incremental updates; the data of modified streams is
+    // written according to the stream data settings. Incremental updates can't be combined with
+    // linearization, QDF mode, PCLm, or encryption, and the input file must not be encrypted or
+    // have a damaged cross-reference table. write() throws std::runtime_error if any of these
+    // conditions are not met. Removed objects are not recorded as free. Added in qpdf 12.4.
+    QPDF_DLL
+    void setIncrementalUpdate(bool);
+
+    // Use up to the given number of threads when writing. The default is 1. With more than one
+    // job, the Flate compression of stream data is performed by worker threads ahead of the
+    // serializer. Objects are still written in the same order, and the output is identical to the
+    // output of a single-threaded write. Retrieving, decoding, and encrypting stream data are
+    // always performed by the writing thread. This has no effect when the decode level is
+    // qpdf_dl_none. Streams that are large enough to be deflated in blocks, which is enabled by
+    // calling the static method Pl_Flate::setBlockThreshold, are compressed by as many of the given
+    // number of threads as are not busy compressing other streams. Added in qpdf 12.4.
+    QPDF_DLL
+    void setJobs(int);
+
+    // Write in low-memory mode. Objects that the writer reads from the input file are released
+    // from the QPDF object's cache once more than the given number of them are in memory, oldest
+    // first, and are read again from the input file if they are needed later. This bounds the
+    // memory used by objects that have not been accessed before writing starts at the cost of
+    // parsing some objects more than once. Unless a limit has been set with
+    // QPDF::setObjectCacheLimit, objects that were already resolved when write() was called,
+    // including all page objects, are never released. If both limits are set, the smaller one
+    // applies while writing. The default of 0 disables this mode. It has no effect when
+    // linearizing. Added in qpdf 12.4.
+    QPDF_DLL
+    void setMaxResidentObjects(size_t);
+
+    // Return the number of bytes of stream data that write() copied unchanged from the input file.
+    // Streams whose data is written exactly as it is stored in the input file, which is the case
+    // when stream data is neither compressed nor decoded or for streams that are already Flate
+    // compressed, are copied directly from the input file to the output in large blocks, or from
+    // the mapping if the input file is memory mapped, without decoding them or holding them in
+    // memory as a whole. This is not possible if the input or output file is encrypted or if the
+    // stream data has been replaced. For linearized files, only the final pass is counted. Added
+    // in qpdf 12.4.
+    QPDF_DLL
+    size_t getCopiedStreamBytes() const;
+
+    // Write objects that are identical to other objects only once. This is useful for files that
+    // were assembled from several other files, which often contain many copies of the same fonts,
+    // images, and ICC profiles. Streams are considered identical if their dictionaries and their
+    // raw data are the same, and other objects if they unparse the same way. References to objects
+    // that are identical to each other are treated as equal, so objects that only refer to
+    // duplicate objects, such as font dictionaries that refer to duplicate font files, are also
+    // found. References to a duplicate object are written as references to the first object that
+    // is identical to it. Objects whose identity matters, such as pages, annotations, form fields,
+    // optional content groups, and objects referenced from the trailer, are always written. The
+    // QPDF object is not modified. Objects may be released while looking for duplicates in
+    // low-memory mode (see setMaxResidentObjects). This has no effect when linearizing, writing an
+    // incremental update, or writing PCLm. Added in qpdf 12.4.
+    QPDF_DLL
+    void setDedupObjects(bool);
+
+    // Return the number of duplicate objects that write() did not write and the total size of their
+    // unparsed dictionaries and raw stream data, which approximates the number of bytes saved by
+    // not writing them (see setDedupObjects). Added in qpdf 12.4.
+    QPDF_DLL
+    std::pair<size_t, size_t> getDedupStats() const;
+
+    // Use the given directory, which must already exist, as a persistent cache of compressed stream
+    // data. Whenever the writer compresses stream data with Flate, which happens when stream data
+    // is decoded and compressed again (see setDecodeLevel, setCompressStreams, and
+    // setRecompressFlate), it first looks for the compressed data in the cache and stores it in the
+    // cache if it was not found. Entries are keyed by a SHA-256 digest of the uncompressed data and
+    // the global Pl_Flate settings, so the output is the same as without a cache. This avoids
+    // compressing streams that occur in many files, such as fonts, images, and ICC profiles, more
+    // than once. Streams smaller than 4 KiB are always compressed directly. Entries that can't be
+    // stored are skipped, so a read-only cache directory may be used. qpdf never removes entries
+    // from the cache. Added in qpdf 12.4.
+    QPDF_DLL
+    void setFlateCache(std::string const& directory);
+
+    // Return the number of cache hits and misses of the last call to write() (see setFlateCache).
+    // When linearizing, stream data is compressed once for each of the two passes, so streams not
+    // found in the cache during the first pass are found during the second. Added in qpdf 12.4.
+    QPDF_DLL
+    std::pair<size_t, size_t> getFlateCacheStats() const;
+
     // If you want to be notified of progress, derive a class from ProgressReporter and override the
     // reportProgress method.
     QPDF_DLL
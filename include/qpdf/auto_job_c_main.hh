@@ -10,17 +10,20 @@ QPDF_DLL Config* check();
 QPDF_DLL Config* checkLinearization();
 QPDF_DLL Config* coalesceContents();
 QPDF_DLL Config* decrypt();
+QPDF_DLL Config* dedupObjects();
 QPDF_DLL Config* deterministicId();
 QPDF_DLL Config* externalizeInlineImages();
 QPDF_DLL Config* filteredStreamData();
 QPDF_DLL Config* flattenRotation();
 QPDF_DLL Config* generateAppearances();
 QPDF_DLL Config* ignoreXrefStreams();
+QPDF_DLL Config* incrementalUpdate();
 QPDF_DLL Config* isEncrypted();
 QPDF_DLL Config* jsonInput();
 QPDF_DLL Config* keepInlineImages();
 QPDF_DLL Config* linearize();
 QPDF_DLL Config* listAttachments();
+QPDF_DLL Config* mmap();
 QPDF_DLL Config* newlineBeforeEndstream();
 QPDF_DLL Config* noOriginalObjectIds();
 QPDF_DLL Config* noWarn();
@@ -56,11 +59,14 @@ QPDF_DLL Config* warningExit0();
 QPDF_DLL Config* withImages();
 QPDF_DLL Config* compressionLevel(std::string const& parameter);
 QPDF_DLL Config* jpegQuality(std::string const& parameter);
+QPDF_DLL Config* jobs(std::string const& parameter);
+QPDF_DLL Config* flateBlockThreshold(std::string const& parameter);
 QPDF_DLL Config* encryptionFilePassword(std::string const& parameter);
 QPDF_DLL Config* forceVersion(std::string const& parameter);
 QPDF_DLL Config* iiMinBytes(std::string const& parameter);
 QPDF_DLL Config* jsonObject(std::string const& parameter);
 QPDF_DLL Config* keepFilesOpenThreshold(std::string const& parameter);
+QPDF_DLL Config* maxResidentObjects(std::string const& parameter);
 QPDF_DLL Config* minVersion(std::string const& parameter);
 QPDF_DLL Config* oiMinArea(std::string const& parameter);
 QPDF_DLL Config* oiMinHeight(std::string const& parameter);
@@ -76,6 +82,7 @@ QPDF_DLL Config* linearizePass1(std::string const& parameter);
 QPDF_DLL Config* passwordFile(std::string const& parameter);
 QPDF_DLL Config* updateFromJson(std::string const& parameter);
 QPDF_DLL Config* jsonStreamPrefix(std::string const& parameter);
+QPDF_DLL Config* flateCache(std::string const& parameter);
 QPDF_DLL Config* collate(std::string const& parameter);
 QPDF_DLL Config* collate();
 QPDF_DLL Config* splitPages(std::string const& parameter);
@@ -83,6 +90,7 @@ QPDF_DLL Config* splitPages();
 QPDF_DLL Config* compressStreams(std::string const& parameter);
 QPDF_DLL Config* decodeLevel(std::string const& parameter);
 QPDF_DLL Config* flattenAnnotations(std::string const& parameter);
+QPDF_DLL Config* flateBackend(std::string const& parameter);
 QPDF_DLL Config* jsonKey(std::string const& parameter);
 QPDF_DLL Config* jsonStreamData(std::string const& parameter);
 QPDF_DLL Config* keepFilesOpen(std::string const& parameter);
@@ -9,6 +9,65 @@
 #include <stdlib.h>
 #include <string>
 
+#if ((defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)))
+# define QPDF_AES_NI
+# include <wmmintrin.h>
+#endif
+
+namespace
+{
+#ifdef QPDF_AES_NI
+    bool
+    have_aes_ni()
+    {
+        static bool const result = __builtin_cpu_supports("sse2") && __builtin_cpu_supports("aes");
+        return result;
+    }
+
+    // The round keys produced by rijndaelSetupEncrypt and rijndaelSetupDecrypt are in the order
+    // and form expected by the AES instructions, stored as 16-byte blocks.
+    __attribute__((target("sse2,aes"))) void
+    aes_ni_update(
+        bool encrypt,
+        bool cbc_mode,
+        unsigned char* cbc_block,
+        unsigned char const* round_keys,
+        unsigned int nrounds,
+        unsigned char const* in_data,
+        unsigned char* out_data)
+    {
+        auto const* keys = reinterpret_cast<__m128i const*>(round_keys);
+        auto* cbc = reinterpret_cast<__m128i*>(cbc_block);
+        __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in_data));
+        __m128i block = in;
+        if (encrypt) {
+            if (cbc_mode) {
+                block = _mm_xor_si128(block, _mm_loadu_si128(cbc));
+            }
+            block = _mm_xor_si128(block, _mm_loadu_si128(keys));
+            for (unsigned int i = 1; i < nrounds; ++i) {
+                block = _mm_aesenc_si128(block, _mm_loadu_si128(keys + i));
+            }
+            block = _mm_aesenclast_si128(block, _mm_loadu_si128(keys + nrounds));
+            if (cbc_mode) {
+                _mm_storeu_si128(cbc, block);
+            }
+        } else {
+            block = _mm_xor_si128(block, _mm_loadu_si128(keys));
+            for (unsigned int i = 1; i < nrounds; ++i) {
+                block = _mm_aesdec_si128(block, _mm_loadu_si128(keys + i));
+            }
+            block = _mm_aesdeclast_si128(block, _mm_loadu_si128(keys + nrounds));
+            if (cbc_mode) {
+                block = _mm_xor_si128(block, _mm_loadu_si128(cbc));
+                _mm_storeu_si128(cbc, in);
+            }
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out_data), block);
+    }
+#endif
+} // namespace
+
 AES_PDF_native::AES_PDF_native(
     bool encrypt,
     unsigned char const* a_key,
@@ -30,11 +89,29 @@ AES_PDF_native::AES_PDF_native(
     } else {
         nrounds = rijndaelSetupDecrypt(rk.get(), key.get(), keybits);
     }
+#ifdef QPDF_AES_NI
+    if (have_aes_ni()) {
+        // Store the round keys as bytes in the order in which rijndael.cc reads and writes blocks.
+        size_t n = 4 * (nrounds + 1);
+        round_keys = std::make_unique<unsigned char[]>(4 * n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                round_keys[4 * i + j] = static_cast<unsigned char>(rk[i] >> (24 - 8 * j));
+            }
+        }
+    }
+#endif
 }
 
 void
 AES_PDF_native::update(unsigned char* in_data, unsigned char* out_data)
 {
+#ifdef QPDF_AES_NI
+    if (round_keys) {
+        aes_ni_update(encrypt, cbc_mode, cbc_block, round_keys.get(), nrounds, in_data, out_data);
+        return;
+    }
+#endif
     if (encrypt) {
         if (cbc_mode) {
             for (size_t i = 0; i < QPDFCryptoImpl::rijndael_buf_size; ++i) {
@@ -293,3 +293,19 @@ is::OffsetBuffer::read(char* buffer, size_t length)
     pos += QIntC::to_offset(len);
     return len;
 }
+
+std::string_view
+is::OffsetBuffer::view(qpdf_offset_t offset, size_t length)
+{
+    seek(offset, SEEK_SET);
+    auto end_pos = static_cast<qpdf_offset_t>(view_.size());
+    if (pos >= end_pos) {
+        last_offset = end_pos + global_offset;
+        return {};
+    }
+
+    last_offset = pos + global_offset;
+    auto result = view_.substr(QIntC::to_size(pos), length);
+    pos += QIntC::to_offset(result.size());
+    return result;
+}
@@ -0,0 +1,175 @@
+#include <qpdf/qpdf-config.h> // include early for large file support
+
+#include <qpdf/MmapInputSource.hh>
+
+#include <qpdf/InputSource_private.hh>
+#include <qpdf/QIntC.hh>
+#include <qpdf/QUtil.hh>
+
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN
+# include <io.h>
+# include <windows.h>
+#elif defined(HAVE_MMAP)
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+using namespace qpdf;
+
+class MmapInputSource::Members
+{
+  public:
+    Members(char const* filename);
+    Members(Members const&) = delete;
+    Members& operator=(Members const&) = delete;
+    ~Members();
+
+  private:
+    // Map the file and return a view of its contents. An empty file results in an empty view.
+    std::string_view map(std::string const& filename);
+
+    void* data{nullptr};
+    size_t size{0};
+#ifdef _WIN32
+    HANDLE mapping{nullptr};
+#endif
+
+  public:
+    is::OffsetBuffer is;
+};
+
+MmapInputSource::Members::Members(char const* filename) :
+    is(filename, map(filename))
+{
+}
+
+MmapInputSource::Members::~Members()
+{
+    if (!data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+#elif defined(HAVE_MMAP)
+    munmap(data, size);
+#endif
+}
+
+std::string_view
+MmapInputSource::Members::map(std::string const& filename)
+{
+    if (!supported()) {
+        throw std::runtime_error("memory mapped files are not supported on this platform");
+    }
+    auto f = QUtil::safe_fopen(filename.data(), "rb");
+    std::unique_ptr<FILE, decltype(&fclose)> closer(f, &fclose);
+#ifdef _WIN32
+    QUtil::seek(f, 0, SEEK_END);
+    size = QIntC::to_size(QUtil::tell(f));
+    if (size == 0) {
+        return {};
+    }
+    auto h = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f)));
+    mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        throw std::runtime_error("unable to create file mapping for " + filename);
+    }
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        throw std::runtime_error("unable to map " + filename);
+    }
+#elif defined(HAVE_MMAP)
+    struct stat st;
+    if (fstat(fileno(f), &st) == -1) {
+        QUtil::throw_system_error("stat " + filename);
+    }
+    size = QIntC::to_size(st.st_size);
+    if (size == 0) {
+        return {};
+    }
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        QUtil::throw_system_error("mmap " + filename);
+    }
+#endif
+    return {static_cast<char const*>(data), size};
+}
+
+MmapInputSource::MmapInputSource(char const* filename) :
+    m(std::make_unique<Members>(filename))
+{
+}
+
+// Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
+MmapInputSource::~MmapInputSource() = default;
+
+bool
+MmapInputSource::supported()
+{
+#if defined(_WIN32) || defined(HAVE_MMAP)
+    return true;
+#else
+    return false;
+#endif
+}
+
+qpdf_offset_t
+MmapInputSource::findAndSkipNextEOL()
+{
+    auto result = m->is.findAndSkipNextEOL();
+    last_offset = m->is.getLastOffset();
+    return result;
+}
+
+std::string const&
+MmapInputSource::getName() const
+{
+    return m->is.getName();
+}
+
+qpdf_offset_t
+MmapInputSource::tell()
+{
+    return m->is.tell();
+}
+
+void
+MmapInputSource::seek(qpdf_offset_t offset, int whence)
+{
+    m->is.seek(offset, whence);
+}
+
+void
+MmapInputSource::rewind()
+{
+    m->is.rewind();
+}
+
+size_t
+MmapInputSource::read(char* buffer, size_t length)
+{
+    auto result = m->is.read(buffer, length);
+    last_offset = m->is.getLastOffset();
+    return result;
+}
+
+void
+MmapInputSource::unreadCh(char ch)
+{
+    m->is.unreadCh(ch);
+}
+
+std::string_view
+MmapInputSource::view(qpdf_offset_t offset, size_t length)
+{
+    auto result = m->is.view(offset, length);
+    last_offset = m->is.getLastOffset();
+    return result;
+}
@@ -12,16 +12,21 @@ using namespace qpdf;
 
 bool Pl_AES_PDF::use_static_iv = false;
 
-Pl_AES_PDF::Pl_AES_PDF(char const* identifier, Pipeline* next, bool encrypt, std::string key) :
+Pl_AES_PDF::Pl_AES_PDF(
+    char const* identifier,
+    Pipeline* next,
+    bool encrypt,
+    std::string key,
+    std::shared_ptr<QPDFCryptoImpl> crypto) :
     Pipeline(identifier, next),
     key(key),
-    crypto(QPDFCryptoProvider::getImpl()),
+    crypto(crypto ? std::move(crypto) : QPDFCryptoProvider::getImpl()),
     encrypt(encrypt)
 {
     util::assertion(next, "Attempt to create Pl_AES_PDF with nullptr as next");
     util::no_ci_rt_error_if(!(key.size() == 32 || key.size() == 16), "unsupported key length");
     std::memset(this->inbuf, 0, this->buf_size);
-    std::memset(this->outbuf, 0, this->buf_size);
+    std::memset(this->outbuf, 0, sizeof(this->outbuf));
     std::memset(this->cbc_block, 0, this->buf_size);
 }
 
@@ -107,6 +112,10 @@ Pl_AES_PDF::finish()
         flush(!disable_padding);
     }
     crypto->rijndael_finalize();
+    if (out_offset > 0) {
+        next()->write(outbuf, out_offset);
+        out_offset = 0;
+    }
     next()->finish();
 }
 
@@ -167,14 +176,15 @@ Pl_AES_PDF::flush(bool strip_padding)
         }
     }
 
-    crypto->rijndael_process(inbuf, outbuf);
+    unsigned char* out = outbuf + out_offset;
+    crypto->rijndael_process(inbuf, out);
     unsigned int bytes = buf_size;
     if (strip_padding) {
-        unsigned char last = outbuf[buf_size - 1];
+        unsigned char last = out[buf_size - 1];
         if (last <= buf_size) {
             bool strip = true;
             for (unsigned int i = 1; i <= last; ++i) {
-                if (outbuf[buf_size - i] != last) {
+                if (out[buf_size - i] != last) {
                     strip = false;
                     break;
                 }
@@ -185,5 +195,9 @@ Pl_AES_PDF::flush(bool strip_padding)
         }
     }
     offset = 0;
-    next()->write(outbuf, bytes);
+    out_offset += bytes;
+    if (out_offset + buf_size > sizeof(outbuf)) {
+        next()->write(outbuf, out_offset);
+        out_offset = 0;
+    }
 }
@@ -3,6 +3,7 @@
 #include <qpdf/QTC.hh>
 #include <qpdf/Util.hh>
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -20,7 +21,39 @@ Pl_ASCII85Decoder::write(unsigned char const* buf, size_t len)
     if (eod > 1) {
         return;
     }
+    // Decoded bytes are collected in out and passed on in chunks. Pending output is always written
+    // before flush is called or an exception is thrown so that the next pipeline sees the same
+    // sequence of bytes as if each group were written as soon as it was decoded.
+    unsigned char out[1024];
+    size_t out_len = 0;
+    auto write_out = [this, &out, &out_len]() {
+        if (out_len > 0) {
+            next()->write(out, out_len);
+            out_len = 0;
+        }
+    };
     for (size_t i = 0; i < len; ++i) {
+        if (pos == 0 && eod == 0 && i + 5 <= len &&
+            std::all_of(buf + i, buf + i + 5, [](unsigned char ch) {
+                return ch >= 33 && ch <= 117;
+            })) {
+            // Decode complete groups without white space directly.
+            unsigned long lval = 0;
+            for (size_t j = 0; j < 5; ++j) {
+                lval *= 85;
+                lval += (buf[i + j] - 33U);
+            }
+            for (int j = 3; j >= 0; --j) {
+                out[out_len + static_cast<size_t>(j)] = lval & 0xff;
+                lval >>= 8;
+            }
+            out_len += 4;
+            i += 4;
+            if (out_len + 4 > sizeof(out)) {
+                write_out();
+            }
+            continue;
+        }
         switch (buf[i]) {
         case ' ':
         case '\f':
@@ -35,6 +68,7 @@ Pl_ASCII85Decoder::write(unsigned char const* buf, size_t len)
         if (eod > 1) {
             break;
         } else if (eod == 1) {
+            write_out();
             util::no_ci_rt_error_if(buf[i] != '>', "broken end-of-data sequence in base 85 data");
             flush();
             eod = 2;
@@ -46,20 +80,25 @@ Pl_ASCII85Decoder::write(unsigned char const* buf, size_t len)
 
             case 'z':
                 if (pos != 0) {
+                    write_out();
                     throw std::runtime_error("unexpected z during base 85 decode");
                 }
-                unsigned char zeroes[4];
-                memset(zeroes, '\0', 4);
-                next()->write(zeroes, 4);
+                memset(out + out_len, '\0', 4);
+                out_len += 4;
+                if (out_len + 4 > sizeof(out)) {
+                    write_out();
+                }
                 break;
 
             default:
                 if (buf[i] < 33 || buf[i] > 117) {
+                    write_out();
                     error = true;
                     throw std::runtime_error("character out of range during base 85 decode");
                 } else {
                     this->inbuf[this->pos++] = buf[i];
                     if (pos == 5) {
+                        write_out();
                         flush();
                     }
                 }
@@ -67,6 +106,7 @@ Pl_ASCII85Decoder::write(unsigned char const* buf, size_t len)
             }
         }
     }
+    write_out();
 }
 
 void
@@ -15,48 +15,82 @@ Pl_ASCIIHexDecoder::Pl_ASCIIHexDecoder(char const* identifier, Pipeline* next) :
     util::assertion(next, "Attempt to create Pl_ASCIIHexDecoder with nullptr as next");
 }
 
+namespace
+{
+    // Value of each hex digit, or one of the following for other characters.
+    unsigned char constexpr hex_space = 16;
+    unsigned char constexpr hex_eod = 17;
+    unsigned char constexpr hex_invalid = 18;
+
+    struct HexValues
+    {
+        constexpr HexValues()
+        {
+            for (int i = 0; i < 256; ++i) {
+                auto ch = static_cast<char>(i);
+                values[i] = util::is_hex_digit(ch)
+                    ? static_cast<unsigned char>(util::hex_decode_char(ch))
+                    : util::is_space(ch) ? hex_space
+                    : ch == '>'          ? hex_eod
+                                         : hex_invalid;
+            }
+        }
+        unsigned char values[256]{};
+    };
+
+    HexValues constexpr hex_values;
+} // namespace
+
 void
 Pl_ASCIIHexDecoder::write(unsigned char const* buf, size_t len)
 {
     if (eod) {
         return;
     }
+    // Decoded bytes are collected in out and passed on in chunks. Pending output is always written
+    // before flush is called or an exception is thrown so that the next pipeline sees the same
+    // sequence of bytes as if each byte were written as soon as it was decoded.
+    unsigned char out[1024];
+    size_t out_len = 0;
+    auto write_out = [this, &out, &out_len]() {
+        if (out_len > 0) {
+            next()->write(out, out_len);
+            out_len = 0;
+        }
+    };
     for (size_t i = 0; i < len; ++i) {
-        char ch = static_cast<char>(toupper(buf[i]));
-        switch (ch) {
-        case ' ':
-        case '\f':
-        case '\v':
-        case '\t':
-        case '\r':
-        case '\n':
+        auto value = hex_values.values[buf[i]];
+        if (value < 16) {
+            if (pos == 0 && i + 1 < len && hex_values.values[buf[i + 1]] < 16) {
+                // Decode pairs of adjacent digits directly.
+                out[out_len++] =
+                    static_cast<unsigned char>((value << 4) + hex_values.values[buf[++i]]);
+                if (out_len == sizeof(out)) {
+                    write_out();
+                }
+                continue;
+            }
+            inbuf[pos++] = static_cast<char>(toupper(buf[i]));
+            if (pos == 2) {
+                write_out();
+                flush();
+            }
+        } else if (value == hex_space) {
             QTC::TC("libtests", "Pl_ASCIIHexDecoder ignore space");
-            // ignore whitespace
-            break;
-
-        case '>':
+        } else if (value == hex_eod) {
+            write_out();
             eod = true;
             flush();
             break;
-
-        default:
-            if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F')) {
-                inbuf[pos++] = ch;
-                if (pos == 2) {
-                    flush();
-                }
-            } else {
-                char t[2];
-                t[0] = ch;
-                t[1] = 0;
-                throw std::runtime_error("character out of range during base Hex decode: "s + t);
-            }
-            break;
-        }
-        if (eod) {
-            break;
+        } else {
+            write_out();
+            char t[2];
+            t[0] = static_cast<char>(toupper(buf[i]));
+            t[1] = 0;
+            throw std::runtime_error("character out of range during base Hex decode: "s + t);
         }
     }
+    write_out();
 }
 
 void
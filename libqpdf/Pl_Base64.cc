@@ -26,6 +26,31 @@ to_i(int i)
     return static_cast<int>(i);
 }
 
+namespace
+{
+    char constexpr alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // Value of each character in base64 or its URL-safe variant, or 64 for anything else.
+    struct DecodeValues
+    {
+        constexpr DecodeValues()
+        {
+            for (auto& v: values) {
+                v = 64;
+            }
+            for (unsigned char i = 0; i < 64; ++i) {
+                values[static_cast<unsigned char>(alphabet[i])] = i;
+            }
+            values['-'] = 62;
+            values['_'] = 63;
+        }
+        unsigned char values[256]{};
+    };
+
+    DecodeValues constexpr decode_values;
+} // namespace
+
 Pl_Base64::Pl_Base64(char const* identifier, Pipeline* next, action_e action) :
     Pipeline(identifier, next),
     action(action)
@@ -61,7 +86,19 @@ Pl_Base64::decode_internal(std::string_view data)
     auto res = (len / 4u + 1u) * 3u;
     out_buffer.reserve(res);
     unsigned char const* p = reinterpret_cast<const unsigned char*>(data.data());
+    auto const* values = decode_values.values;
     while (len > 0) {
+        if (pos == 0 && len >= 4 && !end_of_data &&
+            (values[p[0]] | values[p[1]] | values[p[2]] | values[p[3]]) < 64) {
+            // Decode complete groups without white space or padding directly.
+            unsigned int outval = (unsigned(values[p[0]]) << 18) |
+                (unsigned(values[p[1]]) << 12) | (unsigned(values[p[2]]) << 6) | values[p[3]];
+            char out[3] = {to_c(outval >> 16), to_c(0xff & (outval >> 8)), to_c(0xff & outval)};
+            out_buffer.append(out, 3);
+            p += 4;
+            len -= 4;
+            continue;
+        }
         if (!util::is_space(to_c(*p))) {
             buf[pos++] = *p;
             if (pos == 4) {
@@ -93,6 +130,17 @@ Pl_Base64::encode_internal(std::string_view data)
     auto res = (len / 3u + 1u) * 4u;
     out_buffer.reserve(res);
     unsigned char const* p = reinterpret_cast<const unsigned char*>(data.data());
+    // Encode complete groups directly; flush_encode handles the remaining bytes and padding.
+    for (; pos == 0 && len >= 3; p += 3, len -= 3) {
+        unsigned int inval = (unsigned(p[0]) << 16) | (unsigned(p[1]) << 8) | p[2];
+        char out[4] = {
+            alphabet[inval >> 18],
+            alphabet[0x3f & (inval >> 12)],
+            alphabet[0x3f & (inval >> 6)],
+            alphabet[0x3f & inval],
+        };
+        out_buffer.append(out, 4);
+    }
     while (len > 0) {
         buf[pos++] = *p;
         if (pos == 3) {
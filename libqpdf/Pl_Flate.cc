@@ -1,7 +1,10 @@
 #include <qpdf/Pl_Flate.hh>
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
+#include <deque>
+#include <future>
 #include <zlib.h>
 
 #include <qpdf/QIntC.hh>
@@ -13,15 +16,205 @@
 #ifdef ZOPFLI
 # include <zopfli.h>
 #endif
+#ifdef LIBDEFLATE
+# include <libdeflate.h>
+#endif
 
 using namespace qpdf;
 
 namespace
 {
     static unsigned long long const& memory_limit{global::Limits::flate_max_memory()};
+
+    // Size of the deflate window and therefore of the dictionary used to prime each block.
+    static size_t const dictionary_size = 32768;
+
+    // Compressed input up to this size is collected for inflating with libdeflate. Larger input is
+    // inflated by zlib as it arrives so that streaming consumers don't have to wait for, and hold,
+    // all of it.
+    static size_t const libdeflate_max_inflate_input = 1 << 20;
+
+    struct Block
+    {
+        std::string data;
+        uLong adler{0};
+        size_t size{0};
+    };
+
+    // Deflate one block of a stream that is compressed in blocks to raw deflate data. Every block
+    // except the last one ends with a sync flush so that it ends on a byte boundary and can be
+    // followed by the next block.
+    Block
+    deflate_block(
+        std::string const& identifier,
+        std::string const& data,
+        std::string const& dictionary,
+        int level,
+        bool last)
+    {
+        auto check = [&identifier](char const* prefix, int err, int expected = Z_OK) {
+            if (err != expected) {
+                throw std::runtime_error(
+                    identifier + ": deflate: " + prefix + ": zlib error (" + std::to_string(err) +
+                    ")");
+            }
+        };
+
+        z_stream zstream{};
+        // deflateInit2 is a macro that uses old-style casts.
+#if ((defined(__GNUC__) && ((__GNUC__ * 100) + __GNUC_MINOR__) >= 406) || defined(__clang__))
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+        check("Init", deflateInit2(&zstream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY));
+#if ((defined(__GNUC__) && ((__GNUC__ * 100) + __GNUC_MINOR__) >= 406) || defined(__clang__))
+# pragma GCC diagnostic pop
+#endif
+        std::unique_ptr<z_stream, decltype(&deflateEnd)> end(&zstream, &deflateEnd);
+        if (!dictionary.empty()) {
+            check(
+                "dictionary",
+                deflateSetDictionary(
+                    &zstream,
+                    reinterpret_cast<Bytef const*>(dictionary.data()),
+                    QIntC::to_uint(dictionary.size())));
+        }
+
+        Block block;
+        block.size = data.size();
+        block.adler = adler32(
+            adler32(0, nullptr, 0),
+            reinterpret_cast<Bytef const*>(data.data()),
+            QIntC::to_uint(data.size()));
+        // A sync flush adds an empty stored block of at most six bytes to the bound.
+        block.data.resize(deflateBound(&zstream, QIntC::to_ulong(data.size())) + 16);
+        zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        zstream.avail_in = QIntC::to_uint(data.size());
+        zstream.next_out = reinterpret_cast<Bytef*>(block.data.data());
+        zstream.avail_out = QIntC::to_uint(block.data.size());
+        check(
+            "data",
+            deflate(&zstream, last ? Z_FINISH : Z_SYNC_FLUSH),
+            last ? Z_STREAM_END : Z_OK);
+        util::assertion(
+            zstream.avail_in == 0 && zstream.avail_out > 0,
+            "Pl_Flate: deflate block output exceeds bound");
+        block.data.resize(zstream.total_out);
+        return block;
+    }
 } // namespace
 
+// Deflate data in independent blocks that are compressed by worker threads, in the manner of pigz.
+// The blocks are written in order as raw deflate data between a zlib header and a trailer with the
+// Adler-32 checksum of the complete input, which is combined from the checksums of the blocks.
+class Pl_Flate::Blocks
+{
+  public:
+    Blocks(std::string const& identifier) :
+        identifier(identifier)
+    {
+    }
+
+    void write(Pipeline& next, unsigned char const* data, size_t len);
+    void finish(Pipeline& next);
+
+    std::string buf;
+    bool started{false};
+    int jobs{1};
+
+  private:
+    void dispatch(std::string_view data, bool last);
+    void collect(Pipeline& next);
+
+    std::string identifier;
+    int level{Z_DEFAULT_COMPRESSION};
+    uLong adler{1};
+    std::string dictionary;
+    std::deque<std::future<Block>> pending;
+};
+
+void
+Pl_Flate::Blocks::write(Pipeline& next, unsigned char const* data, size_t len)
+{
+    buf.append(reinterpret_cast<char const*>(data), len);
+    if (!started) {
+        if (buf.size() < Pl_Flate::block_threshold) {
+            return;
+        }
+        started = true;
+        level = Pl_Flate::compression_level;
+        // Header for deflate with a 32 KiB window. FLEVEL matches what zlib writes for the level.
+        int const effective = (level == Z_DEFAULT_COMPRESSION ? 6 : level);
+        unsigned int flevel = 3;
+        if (effective < 2) {
+            flevel = 0;
+        } else if (effective < 6) {
+            flevel = 1;
+        } else if (effective == 6) {
+            flevel = 2;
+        }
+        unsigned int header = (0x78U << 8) | (flevel << 6);
+        header += 31 - header % 31;
+        unsigned char bytes[2] = {
+            static_cast<unsigned char>(header >> 8), static_cast<unsigned char>(header & 0xff)};
+        next.write(bytes, 2);
+    }
+    // Dispatch complete blocks. Remove them from the buffer only at the end so that a large
+    // buffered input is not moved once for every block.
+    size_t offset = 0;
+    while (buf.size() - offset >= Pl_Flate::block_size) {
+        dispatch(std::string_view(buf).substr(offset, Pl_Flate::block_size), false);
+        offset += Pl_Flate::block_size;
+        while (pending.size() >= QIntC::to_size(jobs)) {
+            collect(next);
+        }
+    }
+    buf.erase(0, offset);
+}
+
+void
+Pl_Flate::Blocks::finish(Pipeline& next)
+{
+    dispatch(buf, true);
+    buf.clear();
+    while (!pending.empty()) {
+        collect(next);
+    }
+    unsigned char bytes[4] = {
+        static_cast<unsigned char>((adler >> 24) & 0xff),
+        static_cast<unsigned char>((adler >> 16) & 0xff),
+        static_cast<unsigned char>((adler >> 8) & 0xff),
+        static_cast<unsigned char>(adler & 0xff)};
+    next.write(bytes, 4);
+}
+
+void
+Pl_Flate::Blocks::dispatch(std::string_view data, bool last)
+{
+    std::string block(data);
+    auto prev = std::move(dictionary);
+    dictionary = block.substr(block.size() > dictionary_size ? block.size() - dictionary_size : 0);
+    pending.emplace_back(std::async(
+        jobs > 1 ? std::launch::async : std::launch::deferred,
+        [identifier = identifier,
+         block = std::move(block),
+         prev = std::move(prev),
+         level = level,
+         last]() { return deflate_block(identifier, block, prev, level, last); }));
+}
+
+void
+Pl_Flate::Blocks::collect(Pipeline& next)
+{
+    auto block = pending.front().get();
+    pending.pop_front();
+    adler = adler32_combine(adler, block.adler, static_cast<z_off_t>(block.size));
+    next.write(reinterpret_cast<unsigned char const*>(block.data.data()), block.data.size());
+}
+
 int Pl_Flate::compression_level = Z_DEFAULT_COMPRESSION;
+size_t Pl_Flate::block_threshold = 0;
+Pl_Flate::backend_e Pl_Flate::backend = Pl_Flate::b_zlib;
 
 Pl_Flate::Members::Members(size_t out_bufsize, action_e action) :
     out_bufsize(out_bufsize),
@@ -74,6 +267,12 @@ Pl_Flate::Pl_Flate(
     m(std::make_unique<Members>(QIntC::to_size(out_bufsize_int), action))
 {
     util::assertion(next, "Attempt to create Pl_Flate with nullptr as next");
+    if (action == a_deflate && !m->zopfli_buf && block_threshold > 0) {
+        m->blocks = std::make_unique<Blocks>(identifier);
+    }
+    if (backend == b_libdeflate && !m->zopfli_buf && !m->blocks) {
+        m->libdeflate_buf = std::make_unique<std::string>();
+    }
 }
 
 // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
@@ -114,6 +313,20 @@ Pl_Flate::write(unsigned char const* data, size_t len)
         m->zopfli_buf->append(reinterpret_cast<char const*>(data), len);
         return;
     }
+    if (m->blocks) {
+        m->blocks->write(*next(), data, len);
+        return;
+    }
+    if (m->libdeflate_buf) {
+        if (m->action == a_deflate ||
+            m->libdeflate_buf->size() + len <= libdeflate_max_inflate_input) {
+            m->libdeflate_buf->append(reinterpret_cast<char const*>(data), len);
+            return;
+        }
+        auto buf = std::move(*m->libdeflate_buf);
+        m->libdeflate_buf.reset();
+        write(reinterpret_cast<unsigned char const*>(buf.data()), buf.size());
+    }
 
     // Write in chunks in case len is too big to fit in an int. Assume int is at least 32 bits.
     static size_t const max_bytes = 1 << 30;
@@ -225,6 +438,12 @@ Pl_Flate::finish()
         throw std::runtime_error("PL_Flate memory limit exceeded");
     }
     try {
+        if (m->blocks) {
+            finish_blocks();
+        }
+        if (m->libdeflate_buf) {
+            finish_libdeflate();
+        }
         if (m->zopfli_buf) {
             finish_zopfli();
         } else if (m->outbuf.get()) {
@@ -262,6 +481,64 @@ Pl_Flate::setCompressionLevel(int level)
     compression_level = level;
 }
 
+void
+Pl_Flate::setBlockThreshold(size_t threshold)
+{
+    block_threshold = threshold;
+}
+
+size_t
+Pl_Flate::getBlockThreshold()
+{
+    return block_threshold;
+}
+
+bool
+Pl_Flate::backend_supported(backend_e which)
+{
+    if (which == b_libdeflate) {
+#ifdef LIBDEFLATE
+        return true;
+#else
+        return false;
+#endif
+    }
+    return true;
+}
+
+void
+Pl_Flate::setBackend(backend_e which)
+{
+    util::no_ci_rt_error_if(
+        !backend_supported(which), "Pl_Flate: libdeflate support is not enabled");
+    backend = which;
+}
+
+std::string
+Pl_Flate::compression_settings()
+{
+    if (zopfli_enabled()) {
+        return "zopfli";
+    }
+    auto result = "zlib " + std::string(zlibVersion()) + ", level " +
+        std::to_string(compression_level) + ", block threshold " + std::to_string(block_threshold);
+    if (backend == b_libdeflate) {
+        result += ", libdeflate";
+#ifdef LIBDEFLATE_VERSION_STRING
+        result += " " LIBDEFLATE_VERSION_STRING;
+#endif
+    }
+    return result;
+}
+
+void
+Pl_Flate::setJobs(int jobs)
+{
+    if (m->blocks) {
+        m->blocks->jobs = std::max(1, jobs);
+    }
+}
+
 void
 Pl_Flate::checkError(char const* prefix, int error_code)
 {
@@ -333,6 +610,85 @@ Pl_Flate::finish_zopfli()
 #endif
 }
 
+void
+Pl_Flate::finish_blocks()
+{
+    auto blocks = std::move(m->blocks);
+    if (blocks->started) {
+        blocks->finish(*next());
+    } else if (!blocks->buf.empty()) {
+        // The input is smaller than the threshold, so compress it as usual.
+        write(reinterpret_cast<unsigned char const*>(blocks->buf.data()), blocks->buf.size());
+    }
+    // next()->finish is called by finish()
+}
+
+void
+Pl_Flate::finish_libdeflate()
+{
+#ifdef LIBDEFLATE
+    auto buf = std::move(*m->libdeflate_buf);
+    m->libdeflate_buf.reset();
+    if (buf.empty()) {
+        return;
+    }
+    if (m->action == a_deflate) {
+        std::unique_ptr<libdeflate_compressor, decltype(&libdeflate_free_compressor)> compressor(
+            libdeflate_alloc_compressor(
+                compression_level == Z_DEFAULT_COMPRESSION ? 6 : compression_level),
+            &libdeflate_free_compressor);
+        util::no_ci_rt_error_if(!compressor, identifier + ": deflate: libdeflate: Init failed");
+        std::string out(libdeflate_zlib_compress_bound(compressor.get(), buf.size()), '\0');
+        auto size =
+            libdeflate_zlib_compress(compressor.get(), buf.data(), buf.size(), out.data(), out.size());
+        util::no_ci_rt_error_if(!size, identifier + ": deflate: libdeflate: compression failed");
+        next()->write(reinterpret_cast<unsigned char const*>(out.data()), size);
+        // next()->finish is called by finish()
+        return;
+    }
+
+    std::unique_ptr<libdeflate_decompressor, decltype(&libdeflate_free_decompressor)>
+        decompressor(libdeflate_alloc_decompressor(), &libdeflate_free_decompressor);
+    util::no_ci_rt_error_if(!decompressor, identifier + ": inflate: libdeflate: Init failed");
+    // The uncompressed size is not known, so start with a guess and retry with larger buffers. Data
+    // that does not fit into a buffer of max_out_size bytes, or of the memory limit if that is
+    // smaller, is inflated by zlib, which passes it on in chunks, so that a small stream with a high
+    // compression ratio can't make us allocate an arbitrarily large buffer.
+    static size_t const max_out_size = size_t(1) << 26;
+    auto const out_limit =
+        ::memory_limit ? std::min(QIntC::to_size(::memory_limit), max_out_size) : max_out_size;
+    size_t out_size = std::max(4 * buf.size(), size_t(1) << 16);
+    std::string out;
+    while (true) {
+        out_size = std::min(out_size, out_limit);
+        out.resize(out_size);
+        size_t in_used = 0;
+        size_t out_used = 0;
+        auto result = libdeflate_zlib_decompress_ex(
+            decompressor.get(),
+            buf.data(),
+            buf.size(),
+            out.data(),
+            out.size(),
+            &in_used,
+            &out_used);
+        if (result == LIBDEFLATE_SUCCESS && in_used == buf.size()) {
+            m->written += out_used;
+            next()->write(reinterpret_cast<unsigned char const*>(out.data()), out_used);
+            return;
+        }
+        if (result != LIBDEFLATE_INSUFFICIENT_SPACE || out_size == out_limit) {
+            break;
+        }
+        out_size *= 2;
+    }
+    // Let zlib handle damaged data, trailing data, and data exceeding the buffer size limit so that
+    // partially recoverable data, warnings, and errors are the same as without libdeflate.
+    out = std::string();
+    write(reinterpret_cast<unsigned char const*>(buf.data()), buf.size());
+#endif
+}
+
 bool
 Pl_Flate::zopfli_supported()
 {
@@ -5,7 +5,9 @@
 #include <qpdf/global_private.hh>
 
 #include <climits>
+#include <cstdlib>
 #include <cstring>
+#include <type_traits>
 
 using namespace qpdf;
 
@@ -14,11 +16,92 @@ namespace
     unsigned long long const& memory_limit = global::Limits::png_max_memory();
 } // namespace
 
-static int
-abs_diff(int a, int b)
+namespace
 {
-    return a > b ? a - b : b - a;
-}
+    // The row filters are written so that the compiler can keep the left neighbors in registers
+    // and vectorize where there is no dependency between neighboring bytes. They are instantiated
+    // for the common pixel widths of 1, 3 and 4 bytes, with bpp == 0 selecting a version that
+    // handles any width. The first pixel of each row has no left neighbor.
+
+    template <unsigned int bpp>
+    void
+    decode_sub(unsigned char* buffer, size_t size, size_t width)
+    {
+        if constexpr (bpp == 1) {
+            unsigned char left = 0;
+            for (size_t i = 0; i < size; ++i) {
+                left = buffer[i] = static_cast<unsigned char>(buffer[i] + left);
+            }
+        } else {
+            width = bpp ? bpp : width;
+            for (size_t i = width; i < size; ++i) {
+                buffer[i] = static_cast<unsigned char>(buffer[i] + buffer[i - width]);
+            }
+        }
+    }
+
+    template <unsigned int bpp>
+    void
+    decode_average(
+        unsigned char* buffer, unsigned char const* above, size_t size, size_t width)
+    {
+        width = bpp ? bpp : width;
+        for (size_t i = 0; i < width; ++i) {
+            buffer[i] = static_cast<unsigned char>(buffer[i] + above[i] / 2);
+        }
+        for (size_t i = width; i < size; ++i) {
+            buffer[i] = static_cast<unsigned char>(buffer[i] + (buffer[i - width] + above[i]) / 2);
+        }
+    }
+
+    inline int
+    paeth(int a, int b, int c)
+    {
+        // Equivalent to the PaethPredictor function in the PNG specification, which computes
+        // p = a + b - c and the distances of a, b and c from p.
+        int pa = std::abs(b - c);
+        int pb = std::abs(a - c);
+        int pc = std::abs(a + b - c - c);
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    template <unsigned int bpp>
+    void
+    decode_paeth(unsigned char* buffer, unsigned char const* above, size_t size, size_t width)
+    {
+        width = bpp ? bpp : width;
+        for (size_t i = 0; i < width; ++i) {
+            // With no left neighbors, the predictor is always the byte above.
+            buffer[i] = static_cast<unsigned char>(buffer[i] + above[i]);
+        }
+        for (size_t i = width; i < size; ++i) {
+            buffer[i] = static_cast<unsigned char>(
+                buffer[i] + paeth(buffer[i - width], above[i], above[i - width]));
+        }
+    }
+
+    // Call f with the pixel width as a compile-time constant if it is one of the common widths,
+    // or with 0 otherwise.
+    template <typename F>
+    void
+    with_width(unsigned int width, F f)
+    {
+        switch (width) {
+        case 1:
+            f(std::integral_constant<unsigned int, 1>());
+            break;
+        case 3:
+            f(std::integral_constant<unsigned int, 3>());
+            break;
+        case 4:
+            f(std::integral_constant<unsigned int, 4>());
+            break;
+        default:
+            f(std::integral_constant<unsigned int, 0>());
+            break;
+        }
+    }
+} // namespace
 
 Pl_PNGFilter::Pl_PNGFilter(
     char const* identifier,
@@ -57,6 +140,9 @@ Pl_PNGFilter::Pl_PNGFilter(
 
     // number of bytes per incoming row
     incoming = (action == a_encode ? bytes_per_row : bytes_per_row + 1);
+    if (action == a_encode) {
+        encoded.resize(bytes_per_row + 1);
+    }
 }
 
 void
@@ -134,104 +220,53 @@ Pl_PNGFilter::decodeRow()
 void
 Pl_PNGFilter::decodeSub()
 {
-    unsigned char* buffer = cur_row + 1;
-    unsigned int bpp = bytes_per_pixel;
-
-    for (unsigned int i = 0; i < bytes_per_row; ++i) {
-        unsigned char left = 0;
-
-        if (i >= bpp) {
-            left = buffer[i - bpp];
-        }
-
-        buffer[i] = static_cast<unsigned char>(buffer[i] + left);
-    }
+    with_width(bytes_per_pixel, [this](auto bpp) {
+        decode_sub<decltype(bpp)::value>(cur_row + 1, bytes_per_row, bytes_per_pixel);
+    });
 }
 
 void
 Pl_PNGFilter::decodeUp()
 {
     unsigned char* buffer = cur_row + 1;
-    unsigned char* above_buffer = prev_row + 1;
+    unsigned char const* above_buffer = prev_row + 1;
 
     for (unsigned int i = 0; i < bytes_per_row; ++i) {
-        unsigned char up = above_buffer[i];
-        buffer[i] = static_cast<unsigned char>(buffer[i] + up);
+        buffer[i] = static_cast<unsigned char>(buffer[i] + above_buffer[i]);
     }
 }
 
 void
 Pl_PNGFilter::decodeAverage()
 {
-    unsigned char* buffer = cur_row + 1;
-    unsigned char* above_buffer = prev_row + 1;
-    auto bpp = bytes_per_pixel;
-
-    for (unsigned int i = 0; i < bytes_per_row; ++i) {
-        int left = 0;
-        int up = 0;
-
-        if (i >= bpp) {
-            left = buffer[i - bpp];
-        }
-
-        up = above_buffer[i];
-        buffer[i] = static_cast<unsigned char>(buffer[i] + (left + up) / 2);
-    }
+    with_width(bytes_per_pixel, [this](auto bpp) {
+        decode_average<decltype(bpp)::value>(
+            cur_row + 1, prev_row + 1, bytes_per_row, bytes_per_pixel);
+    });
 }
 
 void
 Pl_PNGFilter::decodePaeth()
 {
-    unsigned char* buffer = cur_row + 1;
-    unsigned char* above_buffer = prev_row + 1;
-    auto bpp = bytes_per_pixel;
-
-    for (unsigned int i = 0; i < bytes_per_row; ++i) {
-        int left = 0;
-        int up = above_buffer[i];
-        int upper_left = 0;
-
-        if (i >= bpp) {
-            left = buffer[i - bpp];
-            upper_left = above_buffer[i - bpp];
-        }
-
-        buffer[i] = static_cast<unsigned char>(buffer[i] + PaethPredictor(left, up, upper_left));
-    }
-}
-
-int
-Pl_PNGFilter::PaethPredictor(int a, int b, int c)
-{
-    int p = a + b - c;
-    int pa = abs_diff(p, a);
-    int pb = abs_diff(p, b);
-    int pc = abs_diff(p, c);
-
-    if (pa <= pb && pa <= pc) {
-        return a;
-    }
-    if (pb <= pc) {
-        return b;
-    }
-    return c;
+    with_width(bytes_per_pixel, [this](auto bpp) {
+        decode_paeth<decltype(bpp)::value>(
+            cur_row + 1, prev_row + 1, bytes_per_row, bytes_per_pixel);
+    });
 }
 
 void
 Pl_PNGFilter::encodeRow()
 {
     // For now, hard-code to using UP filter.
-    unsigned char ch = 2;
-    next()->write(&ch, 1);
+    encoded[0] = 2;
     if (prev_row) {
         for (unsigned int i = 0; i < bytes_per_row; ++i) {
-            ch = static_cast<unsigned char>(cur_row[i] - prev_row[i]);
-            next()->write(&ch, 1);
+            encoded[i + 1] = static_cast<unsigned char>(cur_row[i] - prev_row[i]);
         }
     } else {
-        next()->write(cur_row, bytes_per_row);
+        memcpy(encoded.data() + 1, cur_row, bytes_per_row);
     }
+    next()->write(encoded.data(), encoded.size());
 }
 
 void
@@ -4,11 +4,23 @@
 #include <qpdf/Util.hh>
 #include <qpdf/global_private.hh>
 
+#include <algorithm>
+
 using namespace qpdf;
 
 namespace
 {
     static unsigned long long const& memory_limit{global::Limits::run_length_max_memory()};
+
+    // Pass encoded output collected in out to next.
+    void
+    write_encoded(Pipeline& next, std::string& out)
+    {
+        if (!out.empty()) {
+            next.writeString(out);
+            out.clear();
+        }
+    }
 } // namespace
 
 class Pl_RunLength::Members
@@ -56,6 +68,7 @@ Pl_RunLength::write(unsigned char const* data, size_t len)
 void
 Pl_RunLength::encode(unsigned char const* data, size_t len)
 {
+    // flush_encode appends to m->out, which is passed on once per call.
     for (size_t i = 0; i < len; ++i) {
         util::assertion(
             (m->state == st_top) == (m->length <= 1),
@@ -83,6 +96,7 @@ Pl_RunLength::encode(unsigned char const* data, size_t len)
             ++m->length;
         }
     }
+    write_encoded(*next(), m->out);
 }
 
 void
@@ -110,9 +124,15 @@ Pl_RunLength::decode(unsigned char const* data, size_t len)
             break;
 
         case st_copying:
-            m->out.append(1, static_cast<char>(ch));
-            if (--m->length == 0) {
-                m->state = st_top;
+            {
+                // Copy as much of the literal run as is available at once.
+                size_t n = std::min(size_t(m->length), len - i);
+                m->out.append(reinterpret_cast<char const*>(&ch), n);
+                i += n - 1;
+                m->length -= static_cast<unsigned int>(n);
+                if (m->length == 0) {
+                    m->state = st_top;
+                }
             }
             break;
 
@@ -142,13 +162,11 @@ Pl_RunLength::flush_encode()
         util::assertion(
             !(m->length < 2 || m->length > 128),
             "Pl_RunLength: invalid length in flush_encode for run");
-        auto ch = static_cast<unsigned char>(257 - m->length);
-        next()->write(&ch, 1);
-        next()->write(&m->buf[0], 1);
+        m->out += static_cast<char>(257 - m->length);
+        m->out += static_cast<char>(m->buf[0]);
     } else if (m->length > 0) {
-        auto ch = static_cast<unsigned char>(m->length - 1);
-        next()->write(&ch, 1);
-        next()->write(m->buf, m->length);
+        m->out += static_cast<char>(m->length - 1);
+        m->out.append(reinterpret_cast<char const*>(m->buf), m->length);
     }
     m->state = st_top;
     m->length = 0;
@@ -162,8 +180,8 @@ Pl_RunLength::finish()
     // to do.
     if (m->action == a_encode) {
         flush_encode();
-        unsigned char ch = 128;
-        next()->write(&ch, 1);
+        m->out += static_cast<char>(128);
+        write_encoded(*next(), m->out);
     } else {
         if (memory_limit && (m->out.size()) > memory_limit) {
             throw std::runtime_error("Pl_RunLength memory limit exceeded");
@@ -6,6 +6,7 @@
 #include <qpdf/Util.hh>
 #include <qpdf/global_private.hh>
 
+#include <algorithm>
 #include <climits>
 #include <stdexcept>
 
@@ -78,8 +79,8 @@ void
 Pl_TIFFPredictor::processRow()
 {
     QTC::TC("libtests", "Pl_TIFFPredictor processRow", (action == a_decode ? 0 : 1));
-    previous.assign(samples_per_pixel, 0);
     if (bits_per_sample != 8) {
+        previous.assign(samples_per_pixel, 0);
         BitWriter bw(next());
         BitStream in(cur_row.data(), cur_row.size());
         for (uint32_t col = 0; col < this->columns; ++col) {
@@ -98,24 +99,21 @@ Pl_TIFFPredictor::processRow()
         }
         bw.flush();
     } else {
-        out.clear();
-        auto next_it = cur_row.begin();
-        auto cr_end = cur_row.end();
-        auto pr_end = previous.end();
-
-        while (next_it != cr_end) {
-            for (auto prev = previous.begin(); prev != pr_end && next_it != cr_end;
-                 ++prev, ++next_it) {
-                long long sample = *next_it;
-                long long new_sample = sample;
-                if (action == a_encode) {
-                    new_sample -= *prev;
-                    *prev = sample;
-                } else {
-                    new_sample += *prev;
-                    *prev = new_sample;
-                }
-                out.push_back(static_cast<unsigned char>(255U & new_sample));
+        // With 8-bit samples, each byte is predicted by the byte one pixel to the left. Process
+        // whole rows in loops the compiler can vectorize. The first pixel is not predicted.
+        size_t const size = cur_row.size();
+        size_t const width = std::min(size_t(samples_per_pixel), size);
+        out.resize(size);
+        auto const* in = cur_row.data();
+        auto* result = out.data();
+        std::copy(in, in + width, result);
+        if (action == a_encode) {
+            for (size_t i = width; i < size; ++i) {
+                result[i] = static_cast<unsigned char>(in[i] - in[i - width]);
+            }
+        } else {
+            for (size_t i = width; i < size; ++i) {
+                result[i] = static_cast<unsigned char>(in[i] + result[i - width]);
             }
         }
         next()->write(out.data(), out.size());
@@ -14,6 +14,7 @@
 #include <qpdf/AcroForm.hh>
 #include <qpdf/FileInputSource.hh>
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/QPDFExc.hh>
@@ -222,6 +223,12 @@ QPDF::processFile(char const* description, FILE* filep, bool close_file, char co
     processInputSource(std::shared_ptr<InputSource>(fi), password);
 }
 
+void
+QPDF::processMappedFile(char const* filename, char const* password)
+{
+    processInputSource(std::make_shared<MmapInputSource>(filename), password);
+}
+
 void
 QPDF::processMemoryFile(
     char const* description, char const* buf, size_t length, char const* password)
@@ -687,10 +694,11 @@ QPDF::getRoot()
 std::map<QPDFObjGen, QPDFXRefEntry>
 QPDF::getXRefTable()
 {
-    return m->objects.xref_table();
+    auto const& xref = m->objects.xref_table();
+    return {xref.begin(), xref.end()};
 }
 
-std::map<QPDFObjGen, QPDFXRefEntry> const&
+ObjGenMap<QPDFXRefEntry> const&
 Objects::xref_table()
 {
     util::assertion(m->parsed, "QPDF::getXRefTable called before parsing");
@@ -719,15 +727,23 @@ QPDF::pipeStreamData(
 
     bool attempted_finish = false;
     try {
-        auto buf = file->read(length, offset);
-        if (buf.size() != length) {
+        // Memory mapped files are passed to the pipeline directly from the mapping.
+        std::string buf;
+        std::string_view data;
+        if (auto mapped = dynamic_cast<MmapInputSource*>(file.get())) {
+            data = mapped->view(offset, length);
+        } else {
+            file->read(buf, length, offset);
+            data = buf;
+        }
+        if (data.size() != length) {
             throw qpdf_for_warning.m->c.damagedPDF(
                 *file,
                 "",
-                offset + QIntC::to_offset(buf.size()),
+                offset + QIntC::to_offset(data.size()),
                 "unexpected EOF reading stream data");
         }
-        pipeline->write(buf.data(), length);
+        pipeline->write(data.data(), length);
         attempted_finish = true;
         pipeline->finish();
         return true;
@@ -1186,7 +1186,7 @@ AcroForm::fixCopiedAnnotations(
     AcroForm& from_afdh,
     std::set<QPDFObjGen>* added_fields)
 {
-    auto const& old_annots = from_page["/Annots"];
+    auto old_annots = from_page["/Annots"];
     if (!old_annots) {
         return;
     }
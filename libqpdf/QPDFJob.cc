@@ -1,12 +1,17 @@
 #include <qpdf/QPDFJob_private.hh>
 
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <qpdf/AcroForm.hh>
 #include <qpdf/ClosedFileInputSource.hh>
 #include <qpdf/FileInputSource.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/Pipeline_private.hh>
 #include <qpdf/Pl_DCT.hh>
 #include <qpdf/Pl_Discard.hh>
@@ -396,6 +401,11 @@ std::unique_ptr<QPDF>
 QPDFJob::createQPDF()
 {
     checkConfiguration();
+    // This is a global setting. Set it before reading since it also applies to uncompressing
+    // stream data.
+    if (m->flate_backend) {
+        Pl_Flate::setBackend(*m->flate_backend);
+    }
     std::unique_ptr<QPDF> pdf_sp;
     try {
         processFile(pdf_sp, m->infile_nm(), m->password.data(), true, true);
@@ -470,6 +480,14 @@ QPDFJob::writeQPDF(QPDF& pdf)
         if (!Pl_Flate::zopfli_check_env(pdf.getLogger().get())) {
             m->warnings = true;
         }
+        // These are global settings. Set them once here rather than for each writer since output
+        // files may be written from several threads when splitting pages.
+        if (m->compression_level >= 0) {
+            Pl_Flate::setCompressionLevel(m->compression_level);
+        }
+        if (m->flate_block_threshold) {
+            Pl_Flate::setBlockThreshold(m->flate_block_threshold);
+        }
     }
     if (!createsOutput()) {
         doInspection(pdf);
@@ -594,6 +612,14 @@ QPDFJob::checkConfiguration()
     if (m->check_requires_password && m->check_is_encrypted) {
         usage("--requires-password and --is-encrypted may not be given together");
     }
+    if (m->incremental_update) {
+        if (m->w_cfg.linearize() || m->w_cfg.qdf() || m->split_pages || m->encrypt) {
+            usage(
+                "--incremental-update may not be used with --linearize, --qdf, --split-pages, or "
+                "--encrypt");
+        }
+        m->w_cfg.incremental(true);
+    }
 
     if (m->encrypt && !m->allow_insecure && m->owner_password.empty() &&
         !m->user_password.empty() && m->keylen == 256) {
@@ -1724,6 +1750,10 @@ QPDFJob::doProcessOnce(
 {
     pdf = std::make_unique<QPDF>();
     pdf->doc().config(m->d_cfg.log(m->log));
+    if (main_input && (!createsOutput() || m->json_version)) {
+        // Inspection often only needs a few objects, so avoid parsing whole object streams.
+        pdf->setObjectStreamCacheLimit(16);
+    }
     if (empty) {
         pdf->emptyPDF();
     } else if (main_input && m->json_input) {
@@ -1818,8 +1848,12 @@ QPDFJob::processFile(
     bool used_for_input,
     bool main_input)
 {
-    auto f1 = std::mem_fn<void(char const*, char const*)>(&QPDF::processFile);
-    auto fn = std::bind(f1, std::placeholders::_1, filename, std::placeholders::_2);
+    void (QPDF::*process)(char const*, char const*) = &QPDF::processFile;
+    if (m->mmap) {
+        process = &QPDF::processMappedFile;
+    }
+    auto fn =
+        std::bind(std::mem_fn(process), std::placeholders::_1, filename, std::placeholders::_2);
     doProcess(pdf, fn, password, strcmp(filename, "") == 0, used_for_input, main_input);
 }
 
@@ -2340,11 +2374,26 @@ QPDFJob::Input::initialize(QPDFJob& job, Inputs& in, QPDF* a_qpdf)
     qpdf = a_qpdf ? a_qpdf : qpdf_p.get();
     if (qpdf) {
         auto& doc = qpdf->doc();
-        orig_pages = doc.pages().all();
+        // Only the selected pages of files other than the primary input are needed. If such a file
+        // is linearized, find those pages through the hint tables rather than reading the whole
+        // pages tree.
+        auto n_hinted = a_qpdf ? 0 : qpdf->getLinearizedPageCount();
+        pages_from_hints = n_hinted > 0;
+        if (pages_from_hints) {
+            job.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": " << qpdf->getFilename()
+                  << ": using linearization hint tables to find pages\n";
+            });
+            orig_pages.resize(n_hinted);
+        } else {
+            orig_pages = doc.pages().all();
+        }
         n_pages = static_cast<int>(orig_pages.size());
         copied_pages = std::vector<bool>(orig_pages.size(), false);
 
-        if (job.m->remove_unreferenced_page_resources != QPDFJob::re_no) {
+        if (pages_from_hints && job.m->remove_unreferenced_page_resources == QPDFJob::re_auto) {
+            check_hinted_resources = true;
+        } else if (job.m->remove_unreferenced_page_resources != QPDFJob::re_no) {
             remove_unreferenced = job.shouldRemoveUnreferencedResources(*qpdf);
         }
         if (doc.page_labels().hasPageLabels()) {
@@ -2353,6 +2402,50 @@ QPDFJob::Input::initialize(QPDFJob& job, Inputs& in, QPDF* a_qpdf)
     }
 }
 
+// Return the original page with the given index, looking it up through the hint tables if needed.
+// If that fails for any page, fall back to reading the pages tree.
+QPDFObjectHandle
+QPDFJob::Input::page(QPDFJob& job, size_t idx)
+{
+    auto& result = orig_pages.at(idx);
+    if (result) {
+        return result;
+    }
+    result = qpdf->getLinearizedPage(idx);
+    if (!result.null()) {
+        return result;
+    }
+    QTC::TC("qpdf", "QPDFJob hint tables unusable for page");
+    pages_from_hints = false;
+    if (check_hinted_resources) {
+        check_hinted_resources = false;
+        remove_unreferenced = job.shouldRemoveUnreferencedResources(*qpdf);
+    }
+    auto const& all_pages = qpdf->doc().pages().all();
+    if (all_pages.size() != orig_pages.size()) {
+        throw std::runtime_error(
+            qpdf->getFilename() +
+            ": number of pages in linearization parameter dictionary does not match pages tree");
+    }
+    orig_pages = all_pages;
+    return orig_pages.at(idx);
+}
+
+// Return true if the resources of a page found through the hint tables may be shared with other
+// pages. Objects used by more than one page are not among the page's own objects in the hint tables.
+bool
+QPDFJob::Input::shares_resources(size_t idx)
+{
+    auto& lin = qpdf->doc().linearization();
+    auto resources = orig_pages.at(idx).getKey("/Resources");
+    if (resources.indirect() && !lin.page_private(idx, resources.getObjGen())) {
+        return true;
+    }
+    auto xobject =
+        resources.isDictionary() ? resources.getKey("/XObject") : QPDFObjectHandle::newNull();
+    return xobject.indirect() && !lin.page_private(idx, xobject.getObjGen());
+}
+
 void
 QPDFJob::Inputs::infile_name(std::string const& name)
 {
@@ -2390,7 +2483,14 @@ QPDFJob::Inputs::process(QPDFJob& job, std::string const& filename, QPDFJob::Inp
     job.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
         v << prefix << ": processing " << filename << "\n";
     });
-    if (!keep_files_open) {
+    if (job.m->mmap) {
+        // A mapped file does not hold a file descriptor, so there is no need to close it.
+        job.processInputSource(
+            input.qpdf_p,
+            std::make_shared<MmapInputSource>(filename.data()),
+            password.data(),
+            true);
+    } else if (!keep_files_open) {
         auto cis = std::make_shared<ClosedFileInputSource>(filename.data());
         input.cfis = cis.get();
         input.cfis->stayOpen(true);
@@ -2602,17 +2702,25 @@ QPDFJob::handlePageSpecs(QPDF& pdf)
             if (pldh) {
                 pldh->getLabelsForPageRange(pageno, pageno, out_pageno++, new_labels);
             }
-            QPDFPageObjectHelper to_copy = input.orig_pages.at(page.idx);
+            QPDFPageObjectHelper to_copy = input.page(*this, page.idx);
             if (input.copied_pages[page.idx]) {
                 QTC::TC("qpdf", "QPDFJob copy same page more than once", this_file ? 0 : 1);
                 to_copy = to_copy.shallowCopyPage();
             } else {
                 input.copied_pages[page.idx] = true;
-                if (input.remove_unreferenced) {
+                if (input.remove_unreferenced ||
+                    (input.check_hinted_resources && input.shares_resources(page.idx))) {
                     to_copy.removeUnreferencedResources();
                 }
             }
-            pdf.addPage(to_copy, false);
+            if (input.pages_from_hints) {
+                // Copy the page before adding it. Adding a foreign page pushes inherited attributes
+                // down to all pages of the other file, which would read its whole pages tree, and
+                // pages found through the hint tables don't inherit any attributes.
+                pdf.addPage(added_page(pdf, to_copy), false);
+            } else {
+                pdf.addPage(to_copy, false);
+            }
             auto new_page = added_page(pdf, to_copy);
             // Try to avoid gratuitously renaming fields. In the case of where we're just extracting
             // a bunch of pages from the original file and not copying any page more than once,
@@ -2900,9 +3008,6 @@ parse_version(std::string const& full_version_string, std::string& version, int&
 void
 QPDFJob::setWriterOptions(Writer& w)
 {
-    if (m->compression_level >= 0) {
-        Pl_Flate::setCompressionLevel(m->compression_level);
-    }
     if (m->decrypt) {
         w.setPreserveEncryption(false);
     }
@@ -2977,63 +3082,251 @@ QPDFJob::doSplitPages(QPDF& pdf)
         QPDFPageDocumentHelper dh(pdf);
         dh.removeUnreferencedResources();
     }
-    auto& pldh = doc.page_labels();
-    auto& afdh = doc.acroform();
-    std::vector<QPDFObjectHandle> const& pages = doc.pages().all();
-    size_t pageno_len = std::to_string(pages.size()).length();
-    size_t num_pages = pages.size();
+    size_t num_pages = doc.pages().all().size();
+    size_t pageno_len = std::to_string(num_pages).length();
+
+    struct Split
+    {
+        size_t first;
+        size_t last;
+        std::string outfile;
+        // Only used when splitting in worker threads
+        std::string warnings;
+        std::vector<QPDFExc> source_warnings;
+        std::string annotation_error;
+        std::exception_ptr error;
+        bool opened{false};
+    };
+    std::vector<Split> splits;
     for (size_t i = 0; i < num_pages; i += QIntC::to_size(m->split_pages)) {
         size_t first = i + 1;
-        size_t last = i + QIntC::to_size(m->split_pages);
-        if (last > num_pages) {
-            last = num_pages;
-        }
-        QPDF outpdf;
-        outpdf.doc().config(m->d_cfg);
-        outpdf.emptyPDF();
-        impl::AcroForm* out_afdh = afdh.hasAcroForm() ? &outpdf.doc().acroform() : nullptr;
-        for (size_t pageno = first; pageno <= last; ++pageno) {
-            QPDFObjectHandle page = pages.at(pageno - 1);
-            outpdf.addPage(page, false);
-            auto new_page = added_page(outpdf, page);
-            if (out_afdh) {
-                try {
-                    out_afdh->fixCopiedAnnotations(new_page, page, afdh);
-                } catch (std::exception& e) {
-                    pdf.warn(
-                        qpdf_e_damaged_pdf,
-                        "",
-                        0,
-                        ("Exception caught while fixing copied annotations. This may be a qpdf "
-                         "bug." +
-                         std::string("Exception: ") + e.what()));
+        size_t last = std::min(i + QIntC::to_size(m->split_pages), num_pages);
+        std::string page_range = QUtil::uint_to_string(first, QIntC::to_int(pageno_len));
+        if (m->split_pages > 1) {
+            page_range += "-" + QUtil::uint_to_string(last, QIntC::to_int(pageno_len));
+        }
+        splits.emplace_back(first, last, before + page_range + after);
+    }
+
+    // Write pages first through last of src to split.outfile. If mutex is not null, this is
+    // running in a worker thread. In that case, annotation errors are recorded in the split rather
+    // than issued as warnings, and anything that touches shared job state is done while holding
+    // the mutex.
+    auto write_split =
+        [this](QPDF& src, Split& split, Writer::Config const& cfg, std::mutex* mutex) {
+            auto& src_doc = src.doc();
+            auto& pldh = src_doc.page_labels();
+            auto& afdh = src_doc.acroform();
+            std::vector<QPDFObjectHandle> const& pages = src_doc.pages().all();
+            QPDF outpdf;
+            outpdf.doc().config(m->d_cfg);
+            outpdf.setLogger(src.getLogger());
+            outpdf.emptyPDF();
+            impl::AcroForm* out_afdh = afdh.hasAcroForm() ? &outpdf.doc().acroform() : nullptr;
+            for (size_t pageno = split.first; pageno <= split.last; ++pageno) {
+                QPDFObjectHandle page = pages.at(pageno - 1);
+                outpdf.addPage(page, false);
+                auto new_page = added_page(outpdf, page);
+                if (out_afdh) {
+                    try {
+                        out_afdh->fixCopiedAnnotations(new_page, page, afdh);
+                    } catch (std::exception& e) {
+                        auto msg =
+                            ("Exception caught while fixing copied annotations. This may be a qpdf "
+                             "bug." +
+                             std::string("Exception: ") + e.what());
+                        if (mutex) {
+                            split.annotation_error = msg;
+                        } else {
+                            src.warn(qpdf_e_damaged_pdf, "", 0, msg);
+                        }
+                    }
                 }
             }
+            if (pldh.hasPageLabels()) {
+                std::vector<QPDFObjectHandle> labels;
+                pldh.getLabelsForPageRange(
+                    QIntC::to_longlong(split.first - 1),
+                    QIntC::to_longlong(split.last - 1),
+                    0,
+                    labels);
+                QPDFObjectHandle page_labels = QPDFObjectHandle::newDictionary();
+                page_labels.replaceKey("/Nums", QPDFObjectHandle::newArray(labels));
+                outpdf.getRoot().replaceKey("/PageLabels", page_labels);
+            }
+            if (QUtil::same_file(m->infile_nm(), split.outfile.data())) {
+                throw std::runtime_error(
+                    "split pages would overwrite input file with " + split.outfile);
+            }
+            Writer w(outpdf, cfg);
+            split.opened = true;
+            w.setOutputFilename(split.outfile.data());
+            if (mutex) {
+                std::lock_guard lock(*mutex);
+                setWriterOptions(w);
+            } else {
+                setWriterOptions(w);
+            }
+            w.write();
+        };
+
+    auto n_threads = std::min(QIntC::to_size(m->w_cfg.jobs()), splits.size());
+    if (n_threads <= 1 || m->progress) {
+        for (auto& split: splits) {
+            write_split(pdf, split, m->w_cfg, nullptr);
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": wrote file " << split.outfile << "\n";
+            });
         }
-        if (pldh.hasPageLabels()) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Check the interactive form and page labels here so that any problems with them are reported
+    // against the input file, as they are when splitting sequentially.
+    doc.acroform();
+    auto& pldh = doc.page_labels();
+    if (pldh.hasPageLabels()) {
+        for (auto const& split: splits) {
             std::vector<QPDFObjectHandle> labels;
             pldh.getLabelsForPageRange(
-                QIntC::to_longlong(first - 1), QIntC::to_longlong(last - 1), 0, labels);
-            QPDFObjectHandle page_labels = QPDFObjectHandle::newDictionary();
-            page_labels.replaceKey("/Nums", QPDFObjectHandle::newArray(labels));
-            outpdf.getRoot().replaceKey("/PageLabels", page_labels);
+                QIntC::to_longlong(split.first - 1), QIntC::to_longlong(split.last - 1), 0, labels);
         }
-        std::string page_range = QUtil::uint_to_string(first, QIntC::to_int(pageno_len));
-        if (m->split_pages > 1) {
-            page_range += "-" + QUtil::uint_to_string(last, QIntC::to_int(pageno_len));
+    }
+
+    // QPDF objects may not be shared between threads, so each worker needs its own copy of the
+    // document. Write the document to memory once and have each worker read from that. Streams are
+    // filtered here the same way as they will be when the output files are written, except that
+    // compression is left to the workers. This way, problems with stream data are reported once,
+    // against the input file, and the output files are the same as if the pages had been copied
+    // from pdf directly.
+    std::string source;
+    {
+        Writer::Config cfg;
+        cfg.decode_level(m->w_cfg.decode_level())
+            .compress_streams(m->w_cfg.compress_streams())
+            .recompress_flate(m->w_cfg.recompress_flate())
+            .defer_compression(true)
+            .object_streams(qpdf_o_disable)
+            .preserve_encryption(false);
+        pl::String pl(source);
+        Writer w(pdf, cfg);
+        w.setOutputPipeline(&pl);
+        w.write();
+    }
+
+    // The workers' copies of the document may run into the problems that have already been
+    // reported for the input file. Only report warnings from the copies that have not been seen
+    // yet, once each.
+    std::set<std::string> reported;
+    for (auto const& e: pdf.getWarnings()) {
+        m->warnings = true;
+        reported.insert(e.getMessageDetail());
+    }
+
+    auto d_cfg = m->d_cfg;
+    d_cfg.suppress_warnings(true);
+    auto w_cfg = m->w_cfg;
+    w_cfg.jobs(1);
+    std::mutex mutex;
+    std::atomic<size_t> next{0};
+    std::exception_ptr worker_error;
+    // Warnings issued by the workers' copies of the document are not written out while the workers
+    // run. They are collected and reported in page order once the workers have finished.
+    std::vector<std::vector<QPDFExc>> load_warnings(n_threads);
+    auto worker = [&](size_t id) {
+        std::unique_ptr<QPDF> src;
+        try {
+            src = std::make_unique<QPDF>();
+            src->doc().config(d_cfg);
+            src->processMemoryFile(m->infile_nm(), source.data(), source.size());
+            load_warnings.at(id) = src->getWarnings();
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!worker_error) {
+                worker_error = std::current_exception();
+            }
+            next = splits.size();
+            return;
         }
-        std::string outfile = before + page_range + after;
-        if (QUtil::same_file(m->infile_nm(), outfile.data())) {
-            throw std::runtime_error("split pages would overwrite input file with " + outfile);
+        for (auto i = next++; i < splits.size(); i = next++) {
+            auto& split = splits.at(i);
+            auto log = QPDFLogger::create();
+            log->setWarn(std::make_shared<pl::String>(split.warnings));
+            src->setLogger(log);
+            try {
+                write_split(*src, split, w_cfg, &mutex);
+            } catch (...) {
+                split.error = std::current_exception();
+                next = splits.size();
+            }
+            split.source_warnings = src->getWarnings();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    // When splitting sequentially, no files are written after one fails. Remove files that other
+    // workers wrote for later pages so that the same files are left behind.
+    auto failed = worker_error
+        ? splits.begin()
+        : std::ranges::find_if(splits, [](auto const& split) { return split.error != nullptr; });
+    if (failed != splits.end()) {
+        for (auto it = worker_error ? failed : std::next(failed); it != splits.end(); ++it) {
+            if (it->opened) {
+                try {
+                    QUtil::remove_file(it->outfile.data());
+                } catch (std::exception&) {
+                    // ignore
+                }
+            }
+        }
+    }
+    if (worker_error) {
+        std::rethrow_exception(worker_error);
+    }
+
+    // Report results in the same order as when splitting sequentially.
+    auto report = [&](std::vector<QPDFExc> const& warnings) {
+        for (auto const& e: warnings) {
+            if (reported.insert(e.getMessageDetail()).second) {
+                pdf.warn(e);
+            }
+        }
+    };
+    for (auto const& warnings: load_warnings) {
+        report(warnings);
+    }
+    for (auto& split: splits) {
+        report(split.source_warnings);
+        if (!split.warnings.empty()) {
+            *m->log->getWarn() << split.warnings;
+        }
+        if (!split.annotation_error.empty()) {
+            pdf.warn(qpdf_e_damaged_pdf, "", 0, split.annotation_error);
+        }
+        if (split.error) {
+            std::rethrow_exception(split.error);
         }
-        Writer w(outpdf, m->w_cfg);
-        w.setOutputFilename(outfile.data());
-        setWriterOptions(w);
-        w.write();
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": wrote file " << outfile << "\n";
+            v << prefix << ": wrote file " << split.outfile << "\n";
         });
     }
+    doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        auto seconds = std::max(elapsed.count(), 0.001);
+        v << prefix << ": split " << num_pages << " pages into " << splits.size() << " files in "
+          << QUtil::double_to_string(seconds, 3) << " seconds using " << n_threads << " threads ("
+          << QUtil::double_to_string(static_cast<double>(num_pages) / seconds, 1)
+          << " pages per second)\n";
+    });
 }
 
 void
@@ -3049,6 +3342,10 @@ QPDFJob::writeOutfile(QPDF& pdf)
     } else if (m->outfilename == "-") {
         m->outfilename.clear();
     }
+    size_t released_objects = 0;
+    size_t copied_stream_bytes = 0;
+    std::pair<size_t, size_t> flate_cache_stats;
+    std::pair<size_t, size_t> dedup_stats;
     if (m->json_version) {
         writeJSON(pdf);
     } else {
@@ -3064,6 +3361,33 @@ QPDFJob::writeOutfile(QPDF& pdf)
         }
         setWriterOptions(w);
         w.write();
+        released_objects = w.released_objects();
+        copied_stream_bytes = w.copied_stream_bytes();
+        flate_cache_stats = w.flate_cache_stats();
+        dedup_stats = w.dedup_stats();
+    }
+    if (!m->json_version && m->w_cfg.dedup_objects()) {
+        doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+            v << prefix << ": merged " << dedup_stats.first << " duplicate objects ("
+              << dedup_stats.second << " bytes)\n";
+        });
+    }
+    if (m->w_cfg.max_resident_objects() > 0) {
+        doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+            v << prefix << ": released " << released_objects << " objects while writing\n";
+        });
+    }
+    if (copied_stream_bytes > 0) {
+        doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+            v << prefix << ": copied " << copied_stream_bytes
+              << " bytes of stream data unchanged from the input file\n";
+        });
+    }
+    if (!m->json_version && !m->w_cfg.flate_cache().empty()) {
+        doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+            v << prefix << ": flate cache: " << flate_cache_stats.first << " hits, "
+              << flate_cache_stats.second << " misses\n";
+        });
     }
     if (!m->outfilename.empty()) {
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
@@ -1,5 +1,6 @@
 #include <qpdf/QPDFJob_private.hh>
 
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QPDFUsage.hh>
 #include <qpdf/QTC.hh>
@@ -182,6 +183,52 @@ QPDFJob::Config::compressionLevel(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::jobs(std::string const& parameter)
+{
+    o.m->w_cfg.jobs(to_int("jobs", parameter, 1024, 1));
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::flateBackend(std::string const& parameter)
+{
+    if (parameter == "zlib") {
+        o.m->flate_backend = Pl_Flate::b_zlib;
+    } else if (parameter == "libdeflate") {
+        if (!Pl_Flate::backend_supported(Pl_Flate::b_libdeflate)) {
+            usage("libdeflate support is not enabled");
+        }
+        o.m->flate_backend = Pl_Flate::b_libdeflate;
+    } else {
+        usage("invalid flate backend");
+    }
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::flateBlockThreshold(std::string const& parameter)
+{
+    o.m->flate_block_threshold =
+        to_uint32("flate-block-threshold", parameter, 4'294'967'295, 1);
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::flateCache(std::string const& parameter)
+{
+    o.m->w_cfg.flate_cache(parameter);
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::maxResidentObjects(std::string const& parameter)
+{
+    o.m->w_cfg.max_resident_objects(
+        to_uint32("max-resident-objects", parameter, 4'294'967'295, 1));
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::jpegQuality(std::string const& parameter)
 {
@@ -211,6 +258,21 @@ QPDFJob::Config::decrypt()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::dedupObjects()
+{
+    o.m->w_cfg.dedup_objects(true);
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::incrementalUpdate()
+{
+    // Conflicting options are reported by checkConfiguration regardless of their order.
+    o.m->incremental_update = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::deterministicId()
 {
@@ -436,6 +498,16 @@ QPDFJob::Config::listAttachments()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::mmap()
+{
+    if (!MmapInputSource::supported()) {
+        usage("--mmap is not supported on this platform");
+    }
+    o.m->mmap = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::minVersion(std::string const& parameter)
 {
@@ -1,5 +1,7 @@
 #include <qpdf/QPDFObject_private.hh>
 
+#include <qpdf/QPDFObjectHandle_private.hh>
+
 std::string
 QPDFObject::getDescription()
 {
@@ -57,3 +59,97 @@ QPDFObject::getDescription()
     }
     return {};
 }
+
+QPDFObject::Retain
+QPDFObject::retain() const
+{
+    if (modified) {
+        return Retain::modified;
+    }
+    // A modified or shared descendant takes precedence over an exposed one.
+    auto result = exposed ? Retain::exposed : Retain::no;
+    auto check = [&result](QPDFObjectHandle const& oh) {
+        if (!oh || oh.indirect()) {
+            return false;
+        }
+        auto r = oh.obj_sp().use_count() > 1 ? Retain::shared : oh.obj_sp()->retain();
+        if (r != Retain::no) {
+            result = r;
+        }
+        return r == Retain::modified || r == Retain::shared;
+    };
+    switch (getTypeCode()) {
+    case ::ot_array:
+        {
+            auto const& a = std::get<QPDF_Array>(value);
+            if (a.sp) {
+                for (auto const& item: a.sp->elements) {
+                    if (check(item.second)) {
+                        return result;
+                    }
+                }
+            } else {
+                for (auto const& item: a.elements) {
+                    if (check(item)) {
+                        return result;
+                    }
+                }
+            }
+        }
+        return result;
+    case ::ot_dictionary:
+        for (auto const& item: std::get<QPDF_Dictionary>(value).items) {
+            if (check(item.second)) {
+                return result;
+            }
+        }
+        return result;
+    case ::ot_stream:
+        check(std::get<QPDF_Stream>(value).m->stream_dict);
+        return result;
+    default:
+        return result;
+    }
+}
+
+bool
+QPDFObject::changed(bool include_exposed) const
+{
+    if (modified || (include_exposed && exposed)) {
+        return true;
+    }
+    auto check = [include_exposed](QPDFObjectHandle const& oh) {
+        return oh && !oh.indirect() && oh.obj_sp()->changed(include_exposed);
+    };
+    switch (getTypeCode()) {
+    case ::ot_array:
+        {
+            auto const& a = std::get<QPDF_Array>(value);
+            if (a.sp) {
+                for (auto const& item: a.sp->elements) {
+                    if (check(item.second)) {
+                        return true;
+                    }
+                }
+            } else {
+                for (auto const& item: a.elements) {
+                    if (check(item)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    case ::ot_dictionary:
+        for (auto const& item: std::get<QPDF_Dictionary>(value).items) {
+            if (check(item.second)) {
+                return true;
+            }
+        }
+        return false;
+    case ::ot_stream:
+        return check(std::get<QPDF_Stream>(value).m->stream_dict);
+    default:
+        return false;
+    }
+}
@@ -300,11 +300,13 @@ BaseHandle::copy(bool shallow) const
             if (shallow) {
                 return QPDFObject::create<QPDF_Dictionary>(d.items);
             } else {
-                std::map<std::string, QPDFObjectHandle> new_items;
-                for (auto const& [key, val]: d.items) {
-                    new_items[key] = val.indirect() ? val : val.copy();
+                DictionaryItems new_items(d.items);
+                for (auto& [key, val]: new_items) {
+                    if (!val.indirect()) {
+                        val = val.copy();
+                    }
                 }
-                return QPDFObject::create<QPDF_Dictionary>(new_items);
+                return QPDFObject::create<QPDF_Dictionary>(std::move(new_items));
             }
         }
     case ::ot_stream:
@@ -1297,6 +1299,7 @@ QPDFObjectHandle::makeResourcesIndirect(QPDF& owning_qpdf)
         for (auto& i2: i1.second.as_dictionary()) {
             if (!i2.second.null() && !i2.second.isIndirect()) {
                 i2.second = owning_qpdf.makeIndirectObject(i2.second);
+                i1.second.mark_modified();
             }
         }
     }
@@ -1322,7 +1325,11 @@ QPDFObjectHandle::mergeResources(
 
     // This algorithm is described in comments in QPDFObjectHandle.hh
     // above the declaration of mergeResources.
-    for (auto const& [rtype, value1]: other.as_dictionary()) {
+    // Iterate over copies of other's entries since other may share dictionaries with this.
+    auto other_dict = other.as_dictionary();
+    std::vector<std::pair<std::string, QPDFObjectHandle>> rtypes(
+        other_dict.begin(), other_dict.end());
+    for (auto const& [rtype, value1]: rtypes) {
         auto other_val = value1;
         if (hasKey(rtype)) {
             QPDFObjectHandle this_val = getKey(rtype);
@@ -1338,7 +1345,10 @@ QPDFObjectHandle::mergeResources(
                 std::set<std::string> rnames;
                 int min_suffix = 1;
                 bool initialized_maps = false;
-                for (auto const& [key, value2]: other_val.as_dictionary()) {
+                auto other_val_dict = other_val.as_dictionary();
+                std::vector<std::pair<std::string, QPDFObjectHandle>> entries(
+                    other_val_dict.begin(), other_val_dict.end());
+                for (auto const& [key, value2]: entries) {
                     QPDFObjectHandle rval = value2;
                     if (!this_val.hasKey(key)) {
                         if (!rval.isIndirect()) {
@@ -2276,7 +2286,7 @@ QPDFObjectHandle::isPageObject() const
         return false;
     }
     // getAllPages repairs /Type when traversing the page tree.
-    (void)qpdf()->doc().pages().all();
+    qpdf()->doc().pages().repair_types();
     return isDictionaryOfType("/Page");
 }
 
@@ -2287,7 +2297,7 @@ QPDFObjectHandle::isPagesObject() const
         return false;
     }
     // getAllPages repairs /Type when traversing the page tree.
-    (void)qpdf()->doc().pages().all();
+    qpdf()->doc().pages().repair_types();
     return isDictionaryOfType("/Pages");
 }
 
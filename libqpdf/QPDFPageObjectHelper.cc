@@ -79,7 +79,7 @@ InlineImageTracker::convertIIDict(QPDFObjectHandle odict)
         if (v.null()) {
             continue;
         }
-        auto key = k;
+        std::string key = k;
         auto value = v;
         if (key == "/BPC") {
             key = "/BitsPerComponent";
@@ -336,7 +336,11 @@ QPDFPageObjectHelper::forEachXObject(
         auto& ph = queue.front();
         if (seen.add(ph)) {
             auto xobj_dict = ph.getAttribute("/Resources", false).getKeyIfDict("/XObject");
-            for (auto const& [key, value]: xobj_dict.as_dictionary()) {
+            // Iterate over a copy since action may add or remove entries in xobj_dict.
+            auto xobjs = xobj_dict.as_dictionary();
+            std::vector<std::pair<std::string, QPDFObjectHandle>> entries(
+                xobjs.begin(), xobjs.end());
+            for (auto const& [key, value]: entries) {
                 if (value.null()) {
                     continue;
                 }
@@ -123,22 +123,27 @@ Parser::parse(
     InputSource& input,
     std::string const& object_description,
     qpdf::Tokenizer& tokenizer,
-    QPDFObjectHandle::StringDecrypter* decrypter,
+    BatchStringDecrypter* decrypter,
     QPDF& context,
     bool sanity_checks)
 {
-    return Parser(
-               input,
-               make_description(input.getName(), object_description),
-               object_description,
-               tokenizer,
-               decrypter,
-               &context,
-               true,
-               0,
-               0,
-               sanity_checks)
-        .parse();
+    auto p = Parser(
+        input,
+        make_description(input.getName(), object_description),
+        object_description,
+        tokenizer,
+        decrypter,
+        &context,
+        true,
+        0,
+        0,
+        sanity_checks);
+    p.batch_decrypter_ = decrypter;
+    auto result = p.parse();
+    if (result) {
+        p.decrypt_strings();
+    }
+    return result;
 }
 
 QPDFObjectHandle
@@ -263,7 +268,11 @@ Parser::parse_first(bool content_stream)
         }
 
     case QPDFTokenizer::tt_string:
-        if (decrypter_) {
+        if (batch_decrypter_) {
+            auto result = with_description<QPDF_String>(tokenizer_.getValue());
+            encrypted_strings_.emplace_back(result.getObj());
+            return result;
+        } else if (decrypter_) {
             std::string s{tokenizer_.getValue()};
             decrypter_->decryptString(s);
             return with_description<QPDF_String>(s);
@@ -359,8 +368,8 @@ Parser::parse_remainder(bool content_stream)
         case QPDFTokenizer::tt_array_close:
             if (frame_->state == st_array) {
                 auto object = frame_->null_count > 100
-                    ? QPDFObject::create<QPDF_Array>(std::move(frame_->olist), true)
-                    : QPDFObject::create<QPDF_Array>(std::move(frame_->olist));
+                    ? create<QPDF_Array>(std::move(frame_->olist), true)
+                    : create<QPDF_Array>(std::move(frame_->olist));
                 set_description(object, frame_->offset - 1);
                 // The `offset` points to the next of "[".  Set the rewind offset to point to the
                 // beginning of "[". This has been explicitly tested with whitespace surrounding the
@@ -392,7 +401,7 @@ Parser::parse_remainder(bool content_stream)
                     warn(
                         frame_->offset,
                         "dictionary ended prematurely; using null as value for last key");
-                    dict[frame_->key] = QPDFObject::create<QPDF_Null>();
+                    dict[frame_->key] = create<QPDF_Null>();
                 }
                 if (!frame_->olist.empty()) {
                     if (sanity_checks_) {
@@ -410,7 +419,8 @@ Parser::parse_remainder(bool content_stream)
                     dict["/Contents"] = QPDFObjectHandle::newString(frame_->contents_string);
                     dict["/Contents"].setParsedOffset(frame_->contents_offset);
                 }
-                auto object = QPDFObject::create<QPDF_Dictionary>(std::move(dict));
+                dict.shrink_to_fit();
+                auto object = create<QPDF_Dictionary>(std::move(dict));
                 set_description(object, frame_->offset - 2);
                 // The `offset` points to the next of "<<". Set the rewind offset to point to the
                 // beginning of "<<". This has been explicitly tested with whitespace surrounding
@@ -516,9 +526,13 @@ Parser::parse_remainder(bool content_stream)
                         frame_->contents_offset = input_.getLastOffset();
                         b_contents = false;
                     }
-                    std::string s{val};
-                    decrypter_->decryptString(s);
-                    add_scalar<QPDF_String>(s);
+                    if (batch_decrypter_) {
+                        encrypted_strings_.emplace_back(add_scalar<QPDF_String>(val).getObj());
+                    } else {
+                        std::string s{val};
+                        decrypter_->decryptString(s);
+                        add_scalar<QPDF_String>(s);
+                    }
                 } else {
                     add_scalar<QPDF_String>(val);
                 }
@@ -531,19 +545,35 @@ Parser::parse_remainder(bool content_stream)
     }
 }
 
-void
+QPDFObjectHandle&
 Parser::add(std::shared_ptr<QPDFObject>&& obj)
 {
     if (frame_->state != st_dictionary_value) {
         // If state is st_dictionary_key then there is a missing key. Push onto olist for
         // processing once the tt_dict_close token has been found.
-        frame_->olist.emplace_back(std::move(obj));
-    } else {
-        if (auto res = frame_->dict.insert_or_assign(frame_->key, std::move(obj)); !res.second) {
-            warn_duplicate_key();
-        }
-        frame_->state = st_dictionary_key;
+        return frame_->olist.emplace_back(std::move(obj));
+    }
+    auto res = frame_->dict.insert_or_assign(frame_->key, std::move(obj));
+    if (!res.second) {
+        warn_duplicate_key();
     }
+    frame_->state = st_dictionary_key;
+    return res.first->second;
+}
+
+void
+Parser::decrypt_strings()
+{
+    if (encrypted_strings_.empty()) {
+        return;
+    }
+    std::vector<std::string*> strings;
+    strings.reserve(encrypted_strings_.size());
+    for (auto const& obj: encrypted_strings_) {
+        strings.emplace_back(&std::get<QPDF_String>(obj->value).val);
+    }
+    batch_decrypter_->decryptStrings(strings);
+    encrypted_strings_.clear();
 }
 
 void
@@ -575,13 +605,13 @@ Parser::add_bad_null(std::string const& msg)
 void
 Parser::add_int(int count)
 {
-    auto obj = QPDFObject::create<QPDF_Integer>(int_buffer_[count % 2]);
+    auto obj = create<QPDF_Integer>(int_buffer_[count % 2]);
     obj->setDescription(context_, description_, last_offset_buffer_[count % 2]);
     add(std::move(obj));
 }
 
 template <typename T, typename... Args>
-void
+QPDFObjectHandle&
 Parser::add_scalar(Args&&... args)
 {
     auto limit = Limits::parser_max_container_size(bad_count_ || sanity_checks_);
@@ -591,16 +621,16 @@ Parser::add_scalar(Args&&... args)
         max_bad_count_ = 1;
         check_too_many_bad_tokens(); // always throws Error()
     }
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = create<T>(std::forward<Args>(args)...);
     obj->setDescription(context_, description_, input_.getLastOffset());
-    add(std::move(obj));
+    return add(std::move(obj));
 }
 
 template <typename T, typename... Args>
 QPDFObjectHandle
 Parser::with_description(Args&&... args)
 {
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = create<T>(std::forward<Args>(args)...);
     obj->setDescription(context_, description_, start_);
     return {obj};
 }
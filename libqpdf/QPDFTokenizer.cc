@@ -11,9 +11,11 @@
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
 
+#include <array>
 #include <cstdlib>
 #include <cstring>
 #include <stdexcept>
+#include <string_view>
 
 using namespace qpdf;
 
@@ -31,6 +33,88 @@ is_delimiter(char ch)
 
 namespace
 {
+    // Character classes used by Tokenizer::scanBulk.
+    enum char_class_e : unsigned char {
+        cc_regular = 0,
+        cc_space = 1 << 0,
+        cc_delimiter = 1 << 1,
+        cc_digit = 1 << 2,
+    };
+
+    constexpr auto char_classes = [] {
+        std::array<unsigned char, 256> result{};
+        for (char ch: std::string_view(" \n\r\t\v\f\0", 7)) {
+            result[static_cast<unsigned char>(ch)] = cc_space | cc_delimiter;
+        }
+        for (char ch: std::string_view("/(){}<>[]%")) {
+            result[static_cast<unsigned char>(ch)] = cc_delimiter;
+        }
+        for (unsigned char ch = '0'; ch <= '9'; ++ch) {
+            result[ch] = cc_digit;
+        }
+        return result;
+    }();
+
+    inline unsigned char
+    char_class(char ch)
+    {
+        return char_classes[static_cast<unsigned char>(ch)];
+    }
+
+    // Return the length of the initial run of characters in data that are all in or all not in
+    // the character classes in mask.
+    template <bool in_class>
+    inline size_t
+    span(std::string_view data, unsigned char mask)
+    {
+        size_t i = 0;
+        auto const size = data.size();
+        // Unrolled to let the compiler pipeline the table lookups.
+        while (i + 4 <= size &&
+               ((char_class(data[i]) & mask) != 0) == in_class &&
+               ((char_class(data[i + 1]) & mask) != 0) == in_class &&
+               ((char_class(data[i + 2]) & mask) != 0) == in_class &&
+               ((char_class(data[i + 3]) & mask) != 0) == in_class) {
+            i += 4;
+        }
+        while (i < size && ((char_class(data[i]) & mask) != 0) == in_class) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Return the type of a complete token consisting of regular characters, following the
+    // transitions between st_sign, st_decimal, st_number, st_real and st_literal.
+    tt
+    number_or_word(std::string_view token)
+    {
+        enum { sign, decimal, number, real } state;
+        size_t i = 0;
+        if (token[0] == '+' || token[0] == '-') {
+            state = sign;
+            ++i;
+        } else if (token[0] == '.') {
+            state = decimal;
+            ++i;
+        } else if (char_class(token[0]) & cc_digit) {
+            state = number;
+            ++i;
+        } else {
+            return tt::tt_word;
+        }
+        for (; i < token.size(); ++i) {
+            auto ch = token[i];
+            if (char_class(ch) & cc_digit) {
+                state = state == sign || state == number ? number : real;
+            } else if (ch == '.' && (state == sign || state == number)) {
+                state = state == sign ? decimal : real;
+            } else {
+                return tt::tt_word;
+            }
+        }
+        return state == number ? tt::tt_integer : state == real ? tt::tt_real : tt::tt_word;
+    }
+
     class QPDFWordTokenFinder: public InputSource::Finder
     {
       public:
@@ -87,7 +171,7 @@ Tokenizer::reset()
     type = tt::tt_bad;
     val.clear();
     raw_val.clear();
-    error_message = "";
+    error_message.clear();
     before_token = true;
     in_token = false;
     char_to_unread = '\0';
@@ -978,6 +1062,74 @@ Tokenizer::readToken(InputSource& input, std::string const& context, bool allow_
     return token;
 }
 
+bool
+Tokenizer::scanBulk(InputSource& input, qpdf_offset_t& offset, size_t max_len)
+{
+    // Handle the common cases of white space, names without # escapes, numbers and other literals
+    // by classifying whole runs of buffered characters instead of presenting the characters to the
+    // state machine one at a time. Return true if a token was found. Otherwise, the state machine
+    // takes over at the current position. Tokens are only handled here if their terminating
+    // delimiter is in the buffer. The results are exactly the same as the results of the state
+    // machine, including the handling of the delimiter, which is read and then unread.
+    auto data = input.fastPeek();
+    if (!include_ignorable) {
+        while (!data.empty()) {
+            auto spaces = span<true>(data, cc_space);
+            input.fastSkip(spaces);
+            offset += QIntC::to_offset(spaces);
+            if (spaces < data.size()) {
+                data.remove_prefix(spaces);
+                break;
+            }
+            data = input.fastPeek();
+        }
+    }
+    if (data.empty()) {
+        return false;
+    }
+
+    size_t size = 0;
+    auto ch = data[0];
+    if (char_class(ch) & cc_space) {
+        size = span<true>(data, cc_space);
+        type = tt::tt_space;
+    } else if (ch == '/') {
+        size = 1 + span<false>(data.substr(1), cc_delimiter);
+        if (data.substr(0, size).find('#') != std::string_view::npos) {
+            return false;
+        }
+        type = tt::tt_name;
+    } else if (!(char_class(ch) & cc_delimiter)) {
+        size = span<false>(data, cc_delimiter);
+        type = size < data.size() ? number_or_word(data.substr(0, size)) : tt::tt_word;
+    } else {
+        return false;
+    }
+    if (size == data.size() || (max_len && size >= max_len)) {
+        // The token may continue past the end of the buffer or is too long. Let the state machine
+        // handle it.
+        type = tt::tt_bad;
+        return false;
+    }
+
+    raw_val.assign(data.data(), size);
+    if (type == tt::tt_name) {
+        val = raw_val;
+    } else if (type == tt::tt_word) {
+        if (raw_val == "true" || raw_val == "false") {
+            type = tt::tt_bool;
+        } else if (raw_val == "null") {
+            type = tt::tt_null;
+        }
+    }
+    input.fastSkip(size + 1);
+    before_token = false;
+    in_token = false;
+    char_to_unread = data[size];
+    state = st_token_ready;
+    return true;
+}
+
 bool
 Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_len)
 {
@@ -985,6 +1137,9 @@ Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_
         reset();
     }
     qpdf_offset_t offset = input.fastTell();
+    if (state == st_before_token) {
+        scanBulk(input, offset, max_len);
+    }
 
     while (state != st_token_ready) {
         char ch;
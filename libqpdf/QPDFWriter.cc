@@ -8,6 +8,7 @@
 #include <qpdf/Pl_MD5.hh>
 #include <qpdf/Pl_PNGFilter.hh>
 #include <qpdf/Pl_RC4.hh>
+#include <qpdf/Pl_SHA2.hh>
 #include <qpdf/Pl_StdioFile.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
@@ -19,8 +20,11 @@
 #include <qpdf/Util.hh>
 
 #include <algorithm>
+#include <atomic>
 #include <concepts>
 #include <cstdlib>
+#include <future>
+#include <random>
 #include <stdexcept>
 #include <tuple>
 
@@ -243,6 +247,91 @@ namespace
         unsigned long md5_id{0};
         std::string count_buffer;
     };
+
+    // Deflate data with the global Pl_Flate settings. Streams that are large enough to be deflated
+    // in blocks (see Pl_Flate::setBlockThreshold) are compressed by up to jobs threads.
+    std::string
+    deflate(std::string const& data, int jobs)
+    {
+        std::string result;
+        pl::String s("", nullptr, result);
+        Pl_Flate flate("", &s, Pl_Flate::a_deflate);
+        flate.setJobs(jobs);
+        flate.write(reinterpret_cast<unsigned char const*>(data.data()), data.size());
+        flate.finish();
+        return result;
+    }
+
+    // A persistent cache of deflated stream data with one file per entry in a directory. Entries
+    // are named after the SHA-256 digest of the uncompressed data and of the settings that determine
+    // the compressed data (see Pl_Flate::compression_settings), so writing with a cache produces the
+    // same output as writing without one. New entries are written to a temporary file that is then
+    // renamed, which allows several processes to share a cache directory. Entries that can't be
+    // stored, for example because the directory is read-only, are silently skipped. compress may be
+    // called by several threads at once.
+    class FlateCache
+    {
+      public:
+        // Compressing smaller streams is cheaper than looking them up.
+        static size_t const min_size = 1 << 12;
+
+        FlateCache(std::string const& directory) :
+            directory(directory),
+            settings(Pl_Flate::compression_settings())
+        {
+        }
+
+        std::string
+        compress(std::string const& data, int jobs)
+        {
+            if (data.size() < min_size) {
+                return deflate(data, jobs);
+            }
+            Pl_SHA2 sha(256);
+            sha.writeString(settings);
+            sha.writeString("\n");
+            sha.writeString(data);
+            sha.finish();
+            auto path = directory + "/" + sha.getHexDigest();
+            try {
+                if (QUtil::file_can_be_opened(path.data())) {
+                    auto result = QUtil::read_file_into_string(path.data());
+                    if (!result.empty()) {
+                        ++hits;
+                        return result;
+                    }
+                }
+            } catch (std::runtime_error&) {
+                // Treat unreadable entries as missing.
+            }
+            ++misses;
+            auto result = deflate(data, jobs);
+            auto temp = path + ".~qpdf-temp" + std::to_string(std::random_device()());
+            try {
+                {
+                    QUtil::FileCloser fc(QUtil::safe_fopen(temp.data(), "wb"));
+                    Pl_StdioFile out("flate cache", fc.f);
+                    out.writeString(result);
+                    out.finish();
+                }
+                QUtil::rename_file(temp.data(), path.data());
+            } catch (std::runtime_error&) {
+                try {
+                    QUtil::remove_file(temp.data());
+                } catch (std::runtime_error&) {
+                    // ignore
+                }
+            }
+            return result;
+        }
+
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+
+      private:
+        std::string directory;
+        std::string settings;
+    };
 } // namespace
 
 Pl_stack::Popper::~Popper()
@@ -275,7 +364,7 @@ namespace qpdf::impl
         static int const f_hex_string = 1 << 3;
         static int const f_no_encryption = 1 << 4;
 
-        enum trailer_e { t_normal, t_lin_first, t_lin_second };
+        enum trailer_e { t_normal, t_lin_first, t_lin_second, t_incremental };
 
         Writer() = delete;
         Writer(Writer const&) = delete;
@@ -331,13 +420,28 @@ namespace qpdf::impl
         void enqueuePart(std::vector<QPDFObjectHandle>& part);
         void assignCompressedObjectNumbers(QPDFObjGen og);
         Dictionary trimmed_trailer();
+        void find_duplicates();
+        void append_dedup_key(QPDFObjectHandle const& object, std::string& key, bool top);
 
-        // Returns tuple<filter, compress_stream, is_root_metadata>
+        // Returns tuple<filter, compress_stream, is_root_metadata>. If defer_compression is true,
+        // stream_data is not compressed even if compress_stream is returned as true.
+        std::tuple<const bool, const bool, const bool> will_filter_stream(
+            QPDFObjectHandle stream, std::string* stream_data, bool defer_compression = false);
         std::tuple<const bool, const bool, const bool>
-        will_filter_stream(QPDFObjectHandle stream, std::string* stream_data);
-
-        // Test whether stream would be filtered if it were written.
-        bool will_filter_stream(QPDFObjectHandle stream);
+        encoded_stream(QPDFObjectHandle stream, std::string& stream_data);
+        void encodeStreamsAhead(size_t next);
+        void retain_stream(
+            QPDFObjGen og,
+            std::tuple<const bool, const bool, const bool> const& encoded,
+            std::string& stream_data);
+
+        // Returns tuple<filter, encode_flags, decode_level> describing how stream would be written
+        // before any fallback to writing it unfiltered.
+        std::tuple<bool, int, qpdf_stream_decode_level_e>
+        stream_filtering(QPDFObjectHandle stream, bool is_root_metadata);
+        // If stream's data would be written exactly as it is stored in the input file, return its
+        // length, and otherwise return 0.
+        size_t raw_stream_length(QPDFObjectHandle stream);
         unsigned int bytesNeeded(long long n);
         void writeBinary(unsigned long long val, unsigned int bytes);
         Writer& write(std::string_view str);
@@ -372,6 +476,11 @@ namespace qpdf::impl
         void closeObject(int objid);
         void writeStandard();
         void writeLinearized();
+        void writeIncremental();
+        void writeIncrementalXRef(
+            std::vector<std::pair<QPDFObjGen, qpdf_offset_t>> const& entries,
+            int size,
+            qpdf_offset_t prev);
         void writeEncryptionDictionary();
         void writeHeader();
         void writeHintStream(int hint_id);
@@ -461,6 +570,48 @@ namespace qpdf::impl
         std::string deterministic_id_data;
         bool did_write_setup{false};
 
+        // For encoding streams ahead of the serializer when jobs > 1
+        struct EncodedStream
+        {
+            std::future<std::string> data;
+            bool filter{false};
+            bool compress{false};
+            bool is_root_metadata{false};
+            // The number of threads the encoding may use until its result is collected
+            size_t threads{0};
+        };
+        std::map<QPDFObjGen, EncodedStream> encoded_streams;
+        size_t encode_ahead_next{0};
+
+        // For linearization: stream data that was encoded while optimizing, to be written in both
+        // passes. Data beyond the memory limit is kept in a temporary file.
+        struct RetainedStream
+        {
+            std::string data;
+            qpdf_offset_t offset{-1}; // offset in retained_file if not in memory
+            size_t length{0};
+            bool filter{false};
+            bool compress{false};
+            bool is_root_metadata{false};
+        };
+        std::map<QPDFObjGen, RetainedStream> retained_streams;
+        std::unique_ptr<QUtil::FileCloser> retained_file;
+        size_t retained_bytes{0};
+        int lin_pass{0};
+
+        // For low-memory mode
+        size_t released_objects{0};
+
+        // Number of bytes of stream data copied unchanged from the input file
+        size_t copied_stream_bytes{0};
+
+        // For caching compressed stream data across runs
+        std::shared_ptr<FlateCache> flate_cache;
+
+        // For eliminating duplicate objects; maps each duplicate to the object written instead
+        std::map<QPDFObjGen, QPDFObjGen> duplicates;
+        size_t dedup_bytes{0};
+
         // For progress reporting
         std::shared_ptr<QPDFWriter::ProgressReporter> progress_reporter;
         int events_expected{0};
@@ -817,6 +968,12 @@ QPDFWriter::setLinearizationPass1Filename(std::string const& filename)
     m->cfg.linearize_pass1(filename);
 }
 
+void
+QPDFWriter::setLinearizationMemoryLimit(size_t limit)
+{
+    m->cfg.linearize_memory_limit(limit);
+}
+
 void
 QPDFWriter::setPCLm(bool val)
 {
@@ -842,6 +999,106 @@ Config::pclm(bool val)
     return *this;
 }
 
+void
+QPDFWriter::setIncrementalUpdate(bool val)
+{
+    m->cfg.incremental(val);
+}
+
+Config&
+Config::incremental(bool val)
+{
+    if (val && (pclm_ || linearize_ || qdf_)) {
+        usage("incremental cannot be set when linearize, qdf or pclm are set");
+        return *this;
+    }
+    incremental_ = val;
+    return *this;
+}
+
+void
+QPDFWriter::setJobs(int jobs)
+{
+    m->cfg.jobs(jobs);
+}
+
+void
+QPDFWriter::setMaxResidentObjects(size_t max)
+{
+    m->cfg.max_resident_objects(max);
+}
+
+size_t
+qpdf::Writer::released_objects() const
+{
+    return m->released_objects;
+}
+
+size_t
+qpdf::Writer::copied_stream_bytes() const
+{
+    return m->copied_stream_bytes;
+}
+
+size_t
+QPDFWriter::getCopiedStreamBytes() const
+{
+    return m->copied_stream_bytes;
+}
+
+void
+QPDFWriter::setFlateCache(std::string const& directory)
+{
+    m->cfg.flate_cache(directory);
+}
+
+std::pair<size_t, size_t>
+qpdf::Writer::flate_cache_stats() const
+{
+    if (!m->flate_cache) {
+        return {0, 0};
+    }
+    return {m->flate_cache->hits, m->flate_cache->misses};
+}
+
+void
+QPDFWriter::setDedupObjects(bool val)
+{
+    m->cfg.dedup_objects(val);
+}
+
+std::pair<size_t, size_t>
+qpdf::Writer::dedup_stats() const
+{
+    return {m->duplicates.size(), m->dedup_bytes};
+}
+
+std::pair<size_t, size_t>
+QPDFWriter::getDedupStats() const
+{
+    return {m->duplicates.size(), m->dedup_bytes};
+}
+
+std::pair<size_t, size_t>
+QPDFWriter::getFlateCacheStats() const
+{
+    if (!m->flate_cache) {
+        return {0, 0};
+    }
+    return {m->flate_cache->hits, m->flate_cache->misses};
+}
+
+Config&
+Config::jobs(int val)
+{
+    if (val < 1) {
+        usage("the number of jobs must be at least 1");
+        val = 1;
+    }
+    jobs_ = val;
+    return *this;
+}
+
 void
 QPDFWriter::setR2EncryptionParametersInsecure(
     char const* user_password,
@@ -1400,19 +1657,30 @@ impl::Writer::enqueue(QPDFObjectHandle const& object)
             "Use QPDF::copyForeignObject to add objects from another file." //
         );
 
-        if (cfg.qdf() && object.isStreamOfType("/XRef")) {
-            // As a special case, do not output any extraneous XRef streams in QDF mode. Doing so
-            // will confuse fix-qdf, which expects to see only one XRef stream at the end of the
-            // file. This case can occur when creating a QDF from a file with object streams when
-            // preserving unreferenced objects since the old cross reference streams are not
-            // actually referenced by object number.
-            return;
-        }
-
         QPDFObjGen og = object.getObjGen();
         auto& o = obj[og];
 
+        if (o.renumber == 0 && !duplicates.empty()) {
+            if (auto it = duplicates.find(og); it != duplicates.end()) {
+                // Write references to the duplicate as references to the object that replaces it.
+                // Numbers for objects in object streams are assigned when the object stream is
+                // enqueued, so the number is final once enqueue returns.
+                auto replacement = qpdf.getObject(it->second);
+                enqueue(replacement);
+                o.renumber = obj[replacement].renumber;
+                return;
+            }
+        }
+
         if (o.renumber == 0) {
+            if (cfg.qdf() && object.isStreamOfType("/XRef")) {
+                // As a special case, do not output any extraneous XRef streams in QDF mode. Doing
+                // so will confuse fix-qdf, which expects to see only one XRef stream at the end of
+                // the file. This case can occur when creating a QDF from a file with object streams
+                // when preserving unreferenced objects since the old cross reference streams are
+                // not actually referenced by object number.
+                return;
+            }
             if (o.object_stream > 0) {
                 // This is in an object stream.  Don't process it here.  Instead, enqueue the object
                 // stream.  Object streams always have generation 0.
@@ -1459,7 +1727,13 @@ impl::Writer::enqueue(QPDFObjectHandle const& object)
 void
 impl::Writer::unparseChild(QPDFObjectHandle const& child, size_t level, int flags)
 {
-    if (!cfg.linearize()) {
+    if (cfg.incremental()) {
+        // Incremental updates keep the object numbers of the input file.
+        if (child.indirect()) {
+            write(child.getObjGen().unparse(' ')).write(" R");
+            return;
+        }
+    } else if (!cfg.linearize()) {
         enqueue(child);
     }
     if (child.indirect()) {
@@ -1483,8 +1757,12 @@ impl::Writer::writeTrailer(
     if (which == t_lin_second) {
         write(" /Size ").write(size);
     } else {
+        if (which == t_incremental) {
+            // Write these even if the input file's trailer has no /Size.
+            write(" /Size ").write(size).write(" /Prev ").write(prev);
+        }
         for (auto const& [key, value]: trailer) {
-            if (value.null()) {
+            if (value.null() || (which == t_incremental && key == "/Size")) {
                 continue;
             }
             write_qdf("  ").write_no_qdf(" ").write_name(key).write(" ");
@@ -1536,18 +1814,9 @@ impl::Writer::writeTrailer(
     write_qdf("\n>>").write_no_qdf(" >>");
 }
 
-bool
-impl::Writer::will_filter_stream(QPDFObjectHandle stream)
+std::tuple<bool, int, qpdf_stream_decode_level_e>
+impl::Writer::stream_filtering(QPDFObjectHandle stream, bool is_root_metadata)
 {
-    std::string s;
-    [[maybe_unused]] auto [filter, ignore1, ignore2] = will_filter_stream(stream, &s);
-    return filter;
-}
-
-std::tuple<const bool, const bool, const bool>
-impl::Writer::will_filter_stream(QPDFObjectHandle stream, std::string* stream_data)
-{
-    const bool is_root_metadata = stream.isRootMetadata();
     bool filter = false;
     auto decode_level = cfg.decode_level();
     int encode_flags = 0;
@@ -1582,6 +1851,18 @@ impl::Writer::will_filter_stream(QPDFObjectHandle stream, std::string* stream_da
         filter = true;
         encode_flags = 0;
     }
+    if (cfg.defer_compression()) {
+        encode_flags &= ~qpdf_ef_compress;
+    }
+    return {filter, encode_flags, decode_level};
+}
+
+std::tuple<const bool, const bool, const bool>
+impl::Writer::will_filter_stream(
+    QPDFObjectHandle stream, std::string* stream_data, bool defer_compression)
+{
+    const bool is_root_metadata = stream.isRootMetadata();
+    auto [filter, encode_flags, decode_level] = stream_filtering(stream, is_root_metadata);
 
     for (bool first_attempt: {true, false}) {
         auto pp_stream_data =
@@ -1590,7 +1871,8 @@ impl::Writer::will_filter_stream(QPDFObjectHandle stream, std::string* stream_da
         try {
             if (stream.pipeStreamData(
                     pipeline,
-                    filter ? encode_flags : 0,
+                    filter ? (defer_compression ? encode_flags & ~qpdf_ef_compress : encode_flags)
+                           : 0,
                     filter ? decode_level : qpdf_dl_none,
                     false,
                     first_attempt)) {
@@ -1617,6 +1899,154 @@ impl::Writer::will_filter_stream(QPDFObjectHandle stream, std::string* stream_da
     return {false, false, is_root_metadata};
 }
 
+size_t
+impl::Writer::raw_stream_length(QPDFObjectHandle stream)
+{
+    if (encryption) {
+        return 0;
+    }
+    Stream s = stream;
+    auto qpdf = s.qpdf();
+    // Incremental updates never rewrite stream data that has not been replaced.
+    if (!qpdf || s.getStreamDataBuffer() || s.getStreamDataProvider() || s.isDataModified() ||
+        (!cfg.incremental() && std::get<0>(stream_filtering(stream, s.isRootMetadata()))) ||
+        !qpdf->doc().objects().streams().can_copy_raw(s.offset(), s.getLength())) {
+        return 0;
+    }
+    return s.getLength();
+}
+
+std::tuple<const bool, const bool, const bool>
+impl::Writer::encoded_stream(QPDFObjectHandle stream, std::string& stream_data)
+{
+    if (auto rit = retained_streams.find(stream.getObjGen()); rit != retained_streams.end()) {
+        auto& rs = rit->second;
+        std::tuple<const bool, const bool, const bool> result{
+            rs.filter, rs.compress, rs.is_root_metadata};
+        if (rs.offset < 0) {
+            stream_data = lin_pass == 2 ? std::move(rs.data) : rs.data;
+        } else {
+            auto f = retained_file->f;
+            stream_data.resize(rs.length);
+            if (QUtil::seek(f, rs.offset, SEEK_SET) != 0 ||
+                fread(stream_data.data(), 1, rs.length, f) != rs.length) {
+                throw std::runtime_error(
+                    "error reading retained stream data for " + stream.unparse());
+            }
+        }
+        if (lin_pass == 2) {
+            retained_streams.erase(rit);
+        }
+        return result;
+    }
+    auto it = encoded_streams.find(stream.getObjGen());
+    if (it == encoded_streams.end()) {
+        if (!flate_cache || cfg.decode_level() == qpdf_dl_none) {
+            return will_filter_stream(stream, &stream_data);
+        }
+        auto result = will_filter_stream(stream, &stream_data, true);
+        if (std::get<1>(result)) {
+            stream_data = flate_cache->compress(stream_data, 1);
+        }
+        return result;
+    }
+    auto& es = it->second;
+    stream_data = es.data.get();
+    std::tuple<const bool, const bool, const bool> result{
+        es.filter, es.compress, es.is_root_metadata};
+    encoded_streams.erase(it);
+    return result;
+}
+
+void
+impl::Writer::retain_stream(
+    QPDFObjGen og,
+    std::tuple<const bool, const bool, const bool> const& encoded,
+    std::string& stream_data)
+{
+    RetainedStream rs;
+    std::tie(rs.filter, rs.compress, rs.is_root_metadata) = encoded;
+    rs.length = stream_data.size();
+    if (retained_bytes + rs.length <= cfg.linearize_memory_limit()) {
+        retained_bytes += rs.length;
+        rs.data = std::move(stream_data);
+    } else {
+        if (!retained_file) {
+            retained_file = std::make_unique<QUtil::FileCloser>(std::tmpfile());
+        }
+        auto f = retained_file->f;
+        // If the data can't be kept, it is encoded again in each pass.
+        if (!f || QUtil::seek(f, 0, SEEK_END) != 0) {
+            return;
+        }
+        rs.offset = QUtil::tell(f);
+        if (rs.offset < 0 || fwrite(stream_data.data(), 1, rs.length, f) != rs.length) {
+            return;
+        }
+    }
+    retained_streams.emplace(og, std::move(rs));
+}
+
+void
+impl::Writer::encodeStreamsAhead(size_t next)
+{
+    // Retrieving and decoding stream data requires access to the input source and the object
+    // cache, neither of which is thread-safe, so it is done here on the writing thread. Only the
+    // final Flate compression, which dominates the cost of writing, is handed off to worker
+    // threads. The serializer collects the results in queue order, so the output is identical to
+    // that of a single-threaded write. Compressing in a worker thread is only worth the overhead
+    // for larger streams. Smaller streams are compressed on demand by the serializer. Compression
+    // is not deferred with a decode level of none since pipeStreamData would not otherwise filter
+    // the stream. No more than jobs threads are used at a time. Streams that are large enough to
+    // be deflated in blocks (see Pl_Flate::setBlockThreshold) are deflated by as many threads as
+    // are not in use by other streams.
+    static size_t const min_async_size = 1 << 14;
+
+    if (cfg.jobs() <= 1 || cfg.decode_level() == qpdf_dl_none) {
+        return;
+    }
+    encode_ahead_next = std::max(encode_ahead_next, next);
+    auto const max_ahead = QIntC::to_size(cfg.jobs());
+    auto const block_threshold = Pl_Flate::getBlockThreshold();
+    size_t threads = 0;
+    for (auto const& item: encoded_streams) {
+        threads += item.second.threads;
+    }
+    while (encoded_streams.size() < max_ahead && threads < max_ahead &&
+           encode_ahead_next < object_queue.size()) {
+        auto stream = object_queue.at(encode_ahead_next++);
+        auto og = stream.getObjGen();
+        if (!stream.isStream() || encoded_streams.contains(og) || retained_streams.contains(og) ||
+            (og.getGen() == 0 && object_stream_to_objects.contains(og.getObj())) ||
+            raw_stream_length(stream)) {
+            continue;
+        }
+        std::string data;
+        auto [filter, compress, is_root_metadata] = will_filter_stream(stream, &data, true);
+        auto& es = encoded_streams[og];
+        es.filter = filter;
+        es.compress = compress;
+        es.is_root_metadata = is_root_metadata;
+        if (!compress) {
+            std::promise<std::string> p;
+            p.set_value(std::move(data));
+            es.data = p.get_future();
+        } else {
+            bool const async = data.size() >= min_async_size;
+            bool const blocks = block_threshold > 0 && data.size() >= block_threshold;
+            es.threads = blocks ? max_ahead - threads : (async ? 1 : 0);
+            threads += es.threads;
+            es.data = std::async(
+                async ? std::launch::async : std::launch::deferred,
+                [data = std::move(data),
+                 jobs = QIntC::to_int(std::max(es.threads, size_t(1))),
+                 cache = flate_cache]() {
+                    return cache ? cache->compress(data, jobs) : deflate(data, jobs);
+                });
+        }
+    }
+}
+
 void
 impl::Writer::unparseObject(
     QPDFObjectHandle object, size_t level, int flags, size_t stream_length, bool compress)
@@ -1645,7 +2075,7 @@ impl::Writer::unparseObject(
     } else if (tc == ::ot_dictionary) {
         // Handle special cases for specific dictionaries.
 
-        if (old_og == root_og) {
+        if (old_og == root_og && !cfg.incremental()) {
             // Extensions dictionaries.
 
             // We have one of several cases:
@@ -1809,8 +2239,22 @@ impl::Writer::unparseObject(
         }
 
         flags |= f_stream;
+        if (auto length = raw_stream_length(object)) {
+            // The stream data is written exactly as it is stored in the input file, so copy it
+            // from there without reading it into memory first.
+            cur_stream_length = length;
+            unparseObject(object.getDict(), 0, flags, length, false);
+            write("\nstream\n");
+            Stream s = object;
+            char last_char =
+                s.qpdf()->doc().objects().streams().copy_raw(s.offset(), length, *pipeline);
+            copied_stream_bytes += length;
+            added_newline = cfg.newline_before_endstream() || (cfg.qdf() && last_char != '\n');
+            write(added_newline ? "\nendstream" : "endstream");
+            return;
+        }
         std::string stream_data;
-        auto [filter, compress_stream, is_root_metadata] = will_filter_stream(object, &stream_data);
+        auto [filter, compress_stream, is_root_metadata] = encoded_stream(object, stream_data);
         if (filter) {
             flags |= f_filtered;
         }
@@ -2279,6 +2723,149 @@ impl::Writer::trimmed_trailer()
     return trailer;
 }
 
+void
+impl::Writer::append_dedup_key(QPDFObjectHandle const& object, std::string& key, bool top)
+{
+    if (!top && object.indirect()) {
+        auto og = object.getObjGen();
+        // Follow the chain of replacements. Objects that replace other objects are only ever
+        // replaced by objects that have not been replaced themselves, so there are no loops.
+        for (auto it = duplicates.find(og); it != duplicates.end(); it = duplicates.find(og)) {
+            og = it->second;
+        }
+        key += og.unparse(' ');
+        key += " R";
+    } else if (Array array = object) {
+        key += "[";
+        for (auto const& item: array) {
+            append_dedup_key(item, key, false);
+            key += " ";
+        }
+        key += "]";
+    } else if (Dictionary dict = object) {
+        key += "<<";
+        for (auto const& [k, v]: dict) {
+            if (!v.null()) {
+                key += Name::normalize(k);
+                key += " ";
+                append_dedup_key(v, key, false);
+                key += " ";
+            }
+        }
+        key += ">>";
+    } else if (object.isStream()) {
+        // The length is written by the writer and may be an indirect object.
+        key += "<<";
+        for (auto const& [k, v]: Dictionary(object.getDict())) {
+            if (!v.null() && k != "/Length") {
+                key += Name::normalize(k);
+                key += " ";
+                append_dedup_key(v, key, false);
+                key += " ";
+            }
+        }
+        key += ">>stream";
+    } else {
+        key += object.unparse();
+    }
+}
+
+void
+impl::Writer::find_duplicates()
+{
+    // Objects are duplicates of each other if they are equal after replacing references to
+    // duplicates with references to the objects that replace them. Objects that only differ in
+    // references to objects that are duplicates themselves are only found once those are known,
+    // so repeat until no more duplicates are found. Objects are compared using the SHA-256 digest
+    // of their unparsed form and, for streams, the SHA-256 digest of their raw data. The first of
+    // a set of duplicates in object order replaces the others. Only object ids and digests are
+    // kept between passes, so objects may be released while this runs in low-memory mode.
+    //
+    // Objects whose identity matters are never replaced: objects referenced from the trailer, the
+    // metadata stream, pages and page tree nodes, annotations, optional content groups, and
+    // dictionaries that refer to a parent or, like form fields and structure elements, to a page.
+    std::set<QPDFObjGen> keep;
+    for (auto const& [key, value]: qpdf.getTrailer().as_dictionary()) {
+        if (value.indirect()) {
+            keep.insert(value.getObjGen());
+        }
+    }
+    if (auto metadata = qpdf.getRoot()["/Metadata"]; metadata.indirect()) {
+        keep.insert(metadata.getObjGen());
+    }
+
+    struct Candidate
+    {
+        QPDFObjGen og;
+        std::string data_digest;
+        size_t data_size{0};
+    };
+    std::vector<QPDFObjGen> all;
+    for (auto const& oh: qpdf.getAllObjects()) {
+        all.emplace_back(oh.getObjGen());
+    }
+    std::vector<Candidate> candidates;
+    for (auto const& og: all) {
+        objects.maybe_release();
+        if (keep.contains(og)) {
+            continue;
+        }
+        auto oh = qpdf.getObject(og);
+        if (oh.isStream()) {
+            Name type = oh.getDict()["/Type"];
+            if (type == "/XRef" || type == "/ObjStm") {
+                continue;
+            }
+            Pl_SHA2 sha(256);
+            pl::Count count(1, &sha);
+            bool filtered = false;
+            try {
+                if (!oh.pipeStreamData(&count, &filtered, 0, qpdf_dl_none, true)) {
+                    continue;
+                }
+            } catch (std::exception&) {
+                continue;
+            }
+            candidates.emplace_back(og, sha.getRawDigest(), QIntC::to_size(count.getCount()));
+        } else if (Dictionary dict = oh) {
+            Name type = dict["/Type"];
+            if (type == "/Page" || type == "/Pages" || type == "/Annot" || type == "/OCG" ||
+                type == "/OCMD" || dict.contains("/Parent") || dict.contains("/P") ||
+                dict.contains("/Rect")) {
+                continue;
+            }
+            candidates.emplace_back(og);
+        } else if (oh.isArray()) {
+            candidates.emplace_back(og);
+        }
+    }
+
+    for (bool found = true; found;) {
+        found = false;
+        std::map<std::string, QPDFObjGen> seen;
+        for (auto const& c: candidates) {
+            auto og = c.og;
+            if (duplicates.contains(og)) {
+                continue;
+            }
+            objects.maybe_release();
+            std::string key;
+            append_dedup_key(qpdf.getObject(og), key, true);
+            auto size = key.size() + c.data_size;
+            Pl_SHA2 sha(256);
+            sha.writeString(key);
+            sha.writeString(c.data_digest);
+            sha.finish();
+            auto [it, inserted] = seen.try_emplace(sha.getRawDigest(), og);
+            if (!inserted) {
+                duplicates[og] = it->second;
+                dedup_bytes += size;
+                found = true;
+            }
+        }
+    }
+}
+
 // Make document extension level information direct as required by the spec.
 void
 impl::Writer::prepareFileForWrite()
@@ -2321,6 +2908,14 @@ impl::Writer::doWriteSetup()
 
     // Do preliminary setup
 
+    if (!cfg.flate_cache().empty()) {
+        flate_cache = std::make_shared<FlateCache>(cfg.flate_cache());
+    }
+
+    if (cfg.dedup_objects() && !cfg.linearize() && !cfg.incremental() && !cfg.pclm()) {
+        find_duplicates();
+    }
+
     if (cfg.linearize()) {
         cfg.qdf(false);
     }
@@ -2394,7 +2989,7 @@ impl::Writer::doWriteSetup()
 
         // Generate reverse mapping from object stream to objects
         obj.forEach([this](auto id, auto const& item) -> void {
-            if (item.object_stream > 0) {
+            if (item.object_stream > 0 && !duplicates.contains({id, item.gen})) {
                 auto& vec = object_stream_to_objects[item.object_stream];
                 vec.emplace_back(id, item.gen);
                 if (max_ostream_index < vec.size()) {
@@ -2429,18 +3024,57 @@ QPDFWriter::write()
 void
 impl::Writer::write()
 {
-    doWriteSetup();
+    // In low-memory mode, or if the QPDF object has a bounded object cache, objects read from the
+    // input file are released again once the limit is exceeded. Object values are only released
+    // at points where the writer holds no references into them. If the writer is going to use the
+    // pages cache, build it first so that repairs to the pages tree are made before writing
+    // starts.
+    struct ResidentLimit
+    {
+        ResidentLimit(Doc::Objects& objects, size_t max) :
+            objects(objects),
+            max(objects.max_resident()),
+            evictions(objects.cache_stats().evictions)
+        {
+            if (max > 0 && (this->max == 0 || max < this->max)) {
+                objects.max_resident(max);
+            }
+            objects.auto_release(true);
+        }
+        ~ResidentLimit()
+        {
+            objects.auto_release(false);
+            objects.max_resident(max);
+        }
+        Doc::Objects& objects;
+        size_t max;
+        size_t evictions;
+    };
+    std::unique_ptr<ResidentLimit> resident_limit;
+    if ((cfg.max_resident_objects() > 0 || objects.max_resident() > 0) && !cfg.linearize()) {
+        if (cfg.qdf() || cfg.normalize_content() || cfg.pclm()) {
+            pages.all();
+        }
+        resident_limit = std::make_unique<ResidentLimit>(objects, cfg.max_resident_objects());
+    }
 
-    // Set up progress reporting. For linearized files, we write two passes. events_expected is an
-    // approximation, but it's good enough for progress reporting, which is mostly a guess anyway.
-    events_expected = QIntC::to_int(qpdf.getObjectCount() * (cfg.linearize() ? 2 : 1));
+    if (cfg.incremental()) {
+        writeIncremental();
+    } else {
+        doWriteSetup();
 
-    prepareFileForWrite();
+        // Set up progress reporting. For linearized files, we write two passes. events_expected is
+        // an approximation, but it's good enough for progress reporting, which is mostly a guess
+        // anyway.
+        events_expected = QIntC::to_int(qpdf.getObjectCount() * (cfg.linearize() ? 2 : 1));
 
-    if (cfg.linearize()) {
-        writeLinearized();
-    } else {
-        writeStandard();
+        prepareFileForWrite();
+
+        if (cfg.linearize()) {
+            writeLinearized();
+        } else {
+            writeStandard();
+        }
     }
 
     pipeline->finish();
@@ -2452,6 +3086,9 @@ impl::Writer::write()
         output_buffer = buffer_pipeline->getBuffer();
         buffer_pipeline = nullptr;
     }
+    if (resident_limit) {
+        released_objects = objects.cache_stats().evictions - resident_limit->evictions;
+    }
     indicateProgress(false, true);
 }
 
@@ -2758,11 +3395,19 @@ impl::Writer::writeLinearized()
 
     std::map<int, int> stream_cache;
 
+    // Finding out whether a stream will be filtered requires encoding it, so keep the encoded data
+    // to write it in both passes instead of encoding it again. Streams that are copied from the
+    // input file are never filtered.
     auto skip_stream_parameters = [this, &stream_cache](QPDFObjectHandle& stream) {
         if (auto& result = stream_cache[stream.getObjectID()]) {
             return result;
+        } else if (raw_stream_length(stream)) {
+            return result = 1;
         } else {
-            return result = will_filter_stream(stream) ? 2 : 1;
+            std::string data;
+            auto encoded = encoded_stream(stream, data);
+            retain_stream(stream.getObjGen(), encoded, data);
+            return result = std::get<0>(encoded) ? 2 : 1;
         }
     };
 
@@ -2878,6 +3523,7 @@ impl::Writer::writeLinearized()
     auto pp_pass1 = pipeline_stack.popper();
     auto pp_md5 = pipeline_stack.popper();
     for (int pass: {1, 2}) {
+        lin_pass = pass;
         if (pass == 1) {
             if (!cfg.linearize_pass1().empty()) {
                 lin_pass1_file = QUtil::safe_fopen(cfg.linearize_pass1().data(), "wb");
@@ -2989,7 +3635,10 @@ impl::Writer::writeLinearized()
 
         // Parts 4 through 9
 
-        for (auto const& cur_object: object_queue) {
+        encode_ahead_next = 0;
+        for (size_t i = 0; i < object_queue.size(); ++i) {
+            encodeStreamsAhead(i);
+            auto const& cur_object = object_queue[i];
             if (cur_object.getObjectID() == part6_end_marker) {
                 first_half_max_obj_offset = pipeline->getCount();
             }
@@ -3066,6 +3715,7 @@ impl::Writer::writeLinearized()
             // Close first pass pipeline
             file_size = pipeline->getCount();
             pp_pass1.pop();
+            copied_stream_bytes = 0;
 
             // Save hint offset since it will be set to zero by calling openObject.
             qpdf_offset_t hint_offset1 = new_obj[hint_id].xref.getOffset();
@@ -3097,6 +3747,8 @@ impl::Writer::writeLinearized()
             }
         }
     }
+    retained_streams.clear();
+    retained_file = nullptr;
 }
 
 void
@@ -3200,6 +3852,8 @@ impl::Writer::writeStandard()
 
     // Now start walking queue, outputting each object.
     while (object_queue_front < object_queue.size()) {
+        objects.maybe_release();
+        encodeStreamsAhead(object_queue_front);
         QPDFObjectHandle cur_object = object_queue.at(object_queue_front);
         ++object_queue_front;
         writeObject(cur_object);
@@ -3229,3 +3883,142 @@ impl::Writer::writeStandard()
             object_stream_to_objects.empty() ? 0 : 1);
     }
 }
+
+void
+impl::Writer::writeIncremental()
+{
+    if (cfg.linearize() || cfg.qdf() || cfg.pclm()) {
+        throw std::runtime_error(
+            "QPDFWriter: incremental updates can't be combined with linearization, QDF mode or "
+            "PCLm");
+    }
+    if (encryption || qpdf.isEncrypted()) {
+        throw std::runtime_error(
+            "QPDFWriter: incremental updates of encrypted files and encrypted incremental updates "
+            "are not supported");
+    }
+    auto prev = objects.last_xref_offset();
+    if (prev == 0 || qpdf.doc().reconstructed_xref()) {
+        throw std::runtime_error(
+            "QPDFWriter: unable to write an incremental update because the input file's "
+            "cross-reference table is missing or damaged");
+    }
+
+    auto changed = objects.changed_objects();
+    events_expected = QIntC::to_int(changed.size());
+
+    auto pp_md5 = pipeline_stack.popper();
+    if (cfg.deterministic_id()) {
+        pipeline_stack.activate_md5(pp_md5);
+    }
+
+    // Copy the input file unchanged. Offsets in the input file are relative to the PDF header, so
+    // they remain valid even if there was any material in front of it.
+    if (auto last = objects.copy_input(*pipeline); last != '\n' && last != '\r') {
+        write("\n");
+    }
+
+    auto size_oh = qpdf.getTrailer().getKey("/Size");
+    int size = QIntC::to_int(qpdf.getObjectCount()) + 1;
+    if (size_oh.isInteger()) {
+        size = std::max(size, size_oh.getIntValueAsInt());
+    }
+    std::vector<std::pair<QPDFObjGen, qpdf_offset_t>> entries;
+    for (auto const& og: changed) {
+        indicateProgress(false, false);
+        auto object = qpdf.getObject(og);
+        if (object.isStreamOfType("/XRef")) {
+            // The dictionary of the input file's cross-reference stream is the trailer, which is
+            // written with the new cross-reference section.
+            continue;
+        }
+        entries.emplace_back(og, pipeline->getCount());
+        write(og.unparse(' ')).write(" obj\n");
+        unparseObject(object, 0, 0);
+        write("\nendobj\n");
+        size = std::max(size, og.getObj() + 1);
+    }
+
+    writeIncrementalXRef(entries, size, prev);
+}
+
+void
+impl::Writer::writeIncrementalXRef(
+    std::vector<std::pair<QPDFObjGen, qpdf_offset_t>> const& entries, int size, qpdf_offset_t prev)
+{
+    // Return the first object id and number of objects of each run of consecutive object ids.
+    auto subsections = [](auto const& items) {
+        std::vector<std::pair<int, int>> result;
+        for (auto const& [og, offset]: items) {
+            if (!result.empty() && result.back().first + result.back().second == og.getObj()) {
+                ++result.back().second;
+            } else {
+                result.emplace_back(og.getObj(), 1);
+            }
+        }
+        return result;
+    };
+
+    qpdf_offset_t xref_offset = pipeline->getCount();
+    if (!objects.last_xref_stream()) {
+        // The entry for object 0 is repeated so that the section is never empty.
+        write("xref\n0 1\n0000000000 65535 f \n");
+        auto entry = entries.begin();
+        for (auto const& [first, count]: subsections(entries)) {
+            write(first).write(" ").write(count).write("\n");
+            for (int i = 0; i < count; ++i, ++entry) {
+                write(QUtil::int_to_string(entry->second, 10))
+                    .write(" ")
+                    .write(QUtil::int_to_string(entry->first.getGen(), 5))
+                    .write(" n \n");
+            }
+        }
+        writeTrailer(t_incremental, size, false, prev, 0);
+        write("\n");
+    } else {
+        // The input file's last cross-reference section is a stream, so readers of the input file
+        // support cross-reference streams.
+        int xref_id = size++;
+        auto all_entries = entries;
+        all_entries.emplace_back(QPDFObjGen(xref_id, 0), xref_offset);
+
+        int max_gen = 0;
+        for (auto const& [og, offset]: all_entries) {
+            max_gen = std::max(max_gen, og.getGen());
+        }
+        unsigned int f1_size = bytesNeeded(xref_offset);
+        unsigned int f2_size = bytesNeeded(max_gen);
+        unsigned int esize = 1 + f1_size + f2_size;
+
+        std::string xref_data;
+        {
+            auto pp_xref = pipeline_stack.activate(xref_data);
+            for (auto const& [og, offset]: all_entries) {
+                writeBinary(1, 1);
+                writeBinary(QIntC::to_ulonglong(offset), f1_size);
+                writeBinary(QIntC::to_ulonglong(og.getGen()), f2_size);
+            }
+        }
+        const bool compressed = cfg.compress_streams();
+        if (compressed) {
+            xref_data = pl::pipe<Pl_PNGFilter>(xref_data, Pl_PNGFilter::a_encode, esize);
+            xref_data = pl::pipe<Pl_Flate>(xref_data, Pl_Flate::a_deflate);
+        }
+
+        write(xref_id).write(" 0 obj\n");
+        write("<< /Type /XRef /Length ").write(xref_data.size());
+        if (compressed) {
+            write(" /Filter /FlateDecode /DecodeParms << /Columns ")
+                .write(esize)
+                .write(" /Predictor 12 >>");
+        }
+        write(" /W [ 1 ").write(f1_size).write(" ").write(f2_size).write(" ] /Index [");
+        for (auto const& [first, count]: subsections(all_entries)) {
+            write(" ").write(first).write(" ").write(count);
+        }
+        write(" ]");
+        writeTrailer(t_incremental, size, true, prev, 0);
+        write("\nstream\n").write(xref_data).write("\nendstream\nendobj\n");
+    }
+    write("startxref\n").write(xref_offset).write("\n%%EOF\n");
+}
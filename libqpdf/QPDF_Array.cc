@@ -256,6 +256,7 @@ Array::set(size_t at, QPDFObjectHandle const& oh)
     }
     auto a = array();
     checkOwnership(oh);
+    mark_modified();
     if (a->sp) {
         a->sp->elements[at] = oh;
     } else {
@@ -277,6 +278,7 @@ void
 Array::setFromVector(std::vector<QPDFObjectHandle> const& v)
 {
     auto a = array();
+    mark_modified();
     a->elements.resize(0);
     a->elements.reserve(v.size());
     for (auto const& item: v) {
@@ -299,6 +301,7 @@ Array::insert(size_t at, QPDFObjectHandle const& item)
         push_back(item);
         return true;
     }
+    mark_modified();
     if (!a->sp) {
         a->elements.insert(a->elements.cbegin() + to_i(at), item);
         return true;
@@ -333,6 +336,7 @@ Array::push_back(QPDFObjectHandle const& item)
 {
     auto a = array();
     checkOwnership(item);
+    mark_modified();
     if (a->sp) {
         a->sp->elements[(a->sp->size)++] = item;
     } else {
@@ -347,6 +351,7 @@ Array::erase(size_t at)
     if (at >= size()) {
         return false;
     }
+    mark_modified();
     if (!a->sp) {
         a->elements.erase(a->elements.cbegin() + to_i(at));
         return true;
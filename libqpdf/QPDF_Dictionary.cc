@@ -7,6 +7,96 @@
 using namespace std::literals;
 using namespace qpdf;
 
+DictionaryItems::DictionaryItems(std::map<std::string, QPDFObjectHandle> const& items)
+{
+    if (items.size() > max_flat) {
+        tree = std::make_unique<tree_t>(items.begin(), items.end());
+    } else {
+        flat.reserve(items.size());
+        for (auto const& [key, value]: items) {
+            flat.emplace_back(key, value);
+        }
+    }
+}
+
+DictionaryItems::DictionaryItems(std::map<std::string, QPDFObjectHandle>&& items)
+{
+    if (items.size() > max_flat) {
+        tree = std::make_unique<tree_t>();
+    } else {
+        flat.reserve(items.size());
+    }
+    while (!items.empty()) {
+        auto node = items.extract(items.begin());
+        if (tree) {
+            tree->emplace_hint(tree->end(), std::move(node.key()), std::move(node.mapped()));
+        } else {
+            flat.emplace_back(std::move(node.key()), std::move(node.mapped()));
+        }
+    }
+}
+
+std::map<std::string, QPDFObjectHandle>
+DictionaryItems::as_map() const
+{
+    return {begin(), end()};
+}
+
+void
+DictionaryItems::make_tree()
+{
+    tree = std::make_unique<tree_t>(
+        std::make_move_iterator(flat.begin()), std::make_move_iterator(flat.end()));
+    flat = {};
+}
+
+std::pair<DictionaryItems::iterator, bool>
+DictionaryItems::try_emplace(std::string_view key, QPDFObjectHandle value)
+{
+    if (!tree) {
+        auto it = std::lower_bound(flat.begin(), flat.end(), key, Less());
+        if (it != flat.end() && it->first == key) {
+            return {iterator(&*it), false};
+        }
+        if (flat.size() < max_flat) {
+            it = flat.emplace(it, InternedName(key), std::move(value));
+            return {iterator(&*it), true};
+        }
+        make_tree();
+    }
+    auto it = tree->lower_bound(key);
+    if (it != tree->end() && it->first == key) {
+        return {iterator(it), false};
+    }
+    return {iterator(tree->emplace_hint(it, InternedName(key), std::move(value))), true};
+}
+
+std::pair<DictionaryItems::iterator, bool>
+DictionaryItems::insert_or_assign(std::string_view key, QPDFObjectHandle value)
+{
+    auto result = try_emplace(key);
+    result.first->second = std::move(value);
+    return result;
+}
+
+size_t
+DictionaryItems::erase(std::string_view key)
+{
+    if (tree) {
+        if (auto it = tree->find(key); it != tree->end()) {
+            tree->erase(it);
+            return 1;
+        }
+        return 0;
+    }
+    auto it = std::lower_bound(flat.begin(), flat.end(), key, Less());
+    if (it != flat.end() && it->first == key) {
+        flat.erase(it);
+        return 1;
+    }
+    return 0;
+}
+
 QPDF_Dictionary*
 BaseDictionary::dict() const
 {
@@ -38,6 +128,9 @@ BaseHandle::operator[](std::string const& key) const
 /// keys with a `null` value. This behavior is reflected in this function's implementation,
 /// where a missing key will still return a reference to a newly inserted null value entry.
 ///
+/// Inserting a key marks the dictionary as modified. Otherwise, it is only marked as exposed, since
+/// the value may or may not be changed through the returned reference.
+///
 /// @param key The key for which the corresponding value in the dictionary is retrieved.
 /// @return A reference to the QPDFObjectHandle associated with the specified key.
 /// @throws std::runtime_error if the current object is not a dictionary.
@@ -48,7 +141,13 @@ BaseHandle::at(std::string const& key) const
     if (!d) {
         throw std::runtime_error("Expected a dictionary but found a non-dictionary object");
     }
-    return d->items[key];
+    auto [it, inserted] = d->items.try_emplace(key);
+    if (inserted) {
+        mark_modified();
+    } else {
+        mark_exposed();
+    }
+    return it->second;
 }
 
 /// @brief Checks if the specified key exists in the object.
@@ -77,6 +176,9 @@ BaseHandle::contains(std::string const& key) const
 /// @note Modifying the uninitialized object returned when the key is not found is strictly
 /// prohibited.
 ///
+/// If the key is found, the dictionary is marked as exposed, since the value may or may not be
+/// changed through the returned reference.
+///
 /// @param key The key whose associated value should be retrieved.
 /// @return A reference to the associated value if the key is found or a reference to a static
 /// uninitialized object if the key is not found.
@@ -88,6 +190,7 @@ BaseHandle::find(std::string const& key) const
     if (auto d = as<QPDF_Dictionary>()) {
         auto it = d->items.find(key);
         if (it != d->items.end()) {
+            mark_exposed();
             return it->second;
         }
     }
@@ -106,10 +209,10 @@ BaseDictionary::getKeys()
     return result;
 }
 
-std::map<std::string, QPDFObjectHandle> const&
+std::map<std::string, QPDFObjectHandle>
 BaseDictionary::getAsMap() const
 {
-    return dict()->items;
+    return dict()->items.as_map();
 }
 
 size_t
@@ -117,6 +220,7 @@ BaseHandle::erase(const std::string& key)
 {
     // no-op if key does not exist
     if (auto d = as<QPDF_Dictionary>()) {
+        mark_modified();
         return d->items.erase(key);
     }
     return 0;
@@ -139,6 +243,7 @@ bool
 BaseHandle::replace(std::string const& key, QPDFObjectHandle value)
 {
     if (auto d = as<QPDF_Dictionary>()) {
+        mark_modified();
         if (value.null() && !value.indirect()) {
             // The PDF spec doesn't distinguish between keys with null values and missing keys.
             // Allow indirect nulls which are equivalent to a dangling reference, which is permitted
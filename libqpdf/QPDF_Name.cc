@@ -0,0 +1,117 @@
+#include <qpdf/QPDF_Name.hh>
+
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace qpdf;
+
+namespace
+{
+    struct Hash
+    {
+        using is_transparent = void;
+
+        size_t
+        operator()(std::string_view s) const noexcept
+        {
+            return std::hash<std::string_view>()(s);
+        }
+    };
+
+    class NameTable
+    {
+      public:
+        static NameTable&
+        instance()
+        {
+            // The table is never destroyed so that names held by static objects can still remove
+            // themselves from it during static destruction.
+            static auto* table = new NameTable;
+            return *table;
+        }
+
+        // Return the shared string for name, adding it to the table if necessary. The entry is
+        // removed again when the last InternedName referring to it is destroyed.
+        std::shared_ptr<std::string const>
+        find(std::string_view name)
+        {
+            {
+                std::shared_lock lock(mutex);
+                if (auto it = names.find(name); it != names.end()) {
+                    if (auto value = it->second.lock()) {
+                        return value;
+                    }
+                }
+            }
+            std::unique_lock lock(mutex);
+            auto it = names.find(name);
+            if (it != names.end()) {
+                if (auto value = it->second.lock()) {
+                    return value;
+                }
+                // The last reference to the entry is being dropped. Its deleter will find the
+                // replacement entry and leave it alone.
+                names.erase(it);
+            }
+            std::shared_ptr<std::string const> value(
+                new std::string(name), [this](std::string const* s) { remove(s); });
+            names.emplace(*value, value);
+            return value;
+        }
+
+        size_t
+        size()
+        {
+            std::shared_lock lock(mutex);
+            return names.size();
+        }
+
+      private:
+        void
+        remove(std::string const* s)
+        {
+            {
+                std::unique_lock lock(mutex);
+                if (auto it = names.find(*s); it != names.end() && it->first.data() == s->data()) {
+                    names.erase(it);
+                }
+            }
+            delete s;
+        }
+
+        std::shared_mutex mutex;
+        // Keys point into the strings owned by the entries.
+        std::unordered_map<std::string_view, std::weak_ptr<std::string const>, Hash> names;
+    };
+
+    std::shared_ptr<std::string const> const&
+    empty_name()
+    {
+        static auto const empty = std::make_shared<std::string const>();
+        return empty;
+    }
+} // namespace
+
+InternedName::InternedName() :
+    value(empty_name())
+{
+}
+
+InternedName::InternedName(std::string_view name)
+{
+    if (name.empty()) {
+        value = empty_name();
+    } else if (name.size() <= max_interned_length) {
+        value = NameTable::instance().find(name);
+    } else {
+        value = std::make_shared<std::string const>(name);
+    }
+}
+
+size_t
+InternedName::table_size()
+{
+    return NameTable::instance().size();
+}
@@ -1,7 +1,9 @@
 #include <qpdf/QPDFObjectHandle_private.hh>
 
 #include <qpdf/ContentNormalizer.hh>
+#include <qpdf/InputSource_private.hh>
 #include <qpdf/JSON_writer.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/Pipeline_private.hh>
 #include <qpdf/Pl_Buffer.hh>
@@ -128,6 +130,52 @@ Streams::Streams(Common& common) :
 {
 }
 
+bool
+Streams::can_copy_raw(qpdf_offset_t offset, size_t length)
+{
+    if (m->encp->encrypted || offset <= 0 || length == 0) {
+        return false;
+    }
+    if (file_end_source_.lock() != m->file) {
+        // Determine the length of the input file once rather than for every stream.
+        auto& file = *m->file;
+        auto pos = file.tell();
+        file.seek(0, SEEK_END);
+        file_end_ = file.tell();
+        file.seek(pos, SEEK_SET);
+        file_end_source_ = m->file;
+    }
+    return offset <= file_end_ && length <= toS(file_end_ - offset);
+}
+
+char
+Streams::copy_raw(qpdf_offset_t offset, size_t length, Pipeline& pipeline)
+{
+    // Memory mapped files are passed to the pipeline directly from the mapping. Otherwise, read the
+    // data in large blocks so that large streams are not held in memory as a whole.
+    static size_t const block_size = 1 << 20;
+
+    if (auto mapped = dynamic_cast<MmapInputSource*>(m->file.get())) {
+        auto data = mapped->view(offset, length);
+        if (data.size() != length) {
+            throw damagedPDF(offset + toO(data.size()), "unexpected EOF reading stream data");
+        }
+        pipeline.write(data.data(), length);
+        return data.back();
+    }
+    std::string buf;
+    while (length > 0) {
+        auto count = std::min(length, block_size);
+        if (m->file->read(buf, count, offset) != count) {
+            throw damagedPDF(offset + toO(buf.size()), "unexpected EOF reading stream data");
+        }
+        pipeline.write(buf.data(), count);
+        offset += toO(count);
+        length -= count;
+    }
+    return buf.back();
+}
+
 namespace
 {
     class SF_Crypt final: public QPDFStreamFilter
@@ -771,6 +819,7 @@ Stream::replaceFilterData(
     QPDFObjectHandle const& filter, QPDFObjectHandle const& decode_parms, size_t length)
 {
     auto s = stream();
+    mark_modified();
     if (filter) {
         s->stream_dict.replaceKey("/Filter", filter);
     }
@@ -9,6 +9,7 @@
 #include <qpdf/Pl_Buffer.hh>
 #include <qpdf/Pl_RC4.hh>
 #include <qpdf/Pl_SHA2.hh>
+#include <qpdf/QPDFCryptoProvider.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
@@ -953,19 +954,85 @@ QPDF::getKeyForObject(std::shared_ptr<EncryptionParameters> encp, QPDFObjGen og,
         throw std::logic_error("request for encryption key in non-encrypted PDF");
     }
 
-    if (og != encp->cached_key_og) {
+    // The key depends on whether AES is used, which may differ between an object's strings and
+    // its stream data if they use different crypt filters.
+    if (og != encp->cached_key_og || use_aes != encp->cached_key_aes) {
         encp->cached_object_encryption_key = compute_data_key(
             encp->encryption_key, og.getObj(), og.getGen(), use_aes, encp->encryption_V, encp->R());
         encp->cached_key_og = og;
+        encp->cached_key_aes = use_aes;
     }
 
     return encp->cached_object_encryption_key;
 }
 
+// Decrypt strings in place. Each string consists of an initialization vector followed by the
+// encrypted data. In CBC mode, each block is decrypted using the block before it, which for the
+// first data block of a string is the string's initialization vector, even if the strings are
+// concatenated. This allows all strings of an object to be decrypted in a single pass. The output
+// for the initialization vectors themselves is discarded. Each result is the same as that of
+// passing the string through a Pl_AES_PDF decryption pipeline.
+static void
+decrypt_aes_strings(
+    QPDFCryptoImpl& crypto, std::string const& key, std::vector<std::string*> const& strings)
+{
+    static size_t constexpr buf_size = QPDFCryptoImpl::rijndael_buf_size;
+    util::no_ci_rt_error_if(!(key.size() == 32 || key.size() == 16), "unsupported key length");
+    std::string in;
+    for (auto* str: strings) {
+        if (str->size() <= buf_size) {
+            // There is nothing other than the initialization vector.
+            str->clear();
+        } else {
+            // As in Pl_AES_PDF, pad incomplete blocks with zeroes.
+            in += *str;
+            in.resize((in.size() + buf_size - 1) / buf_size * buf_size, '\0');
+        }
+    }
+    if (in.empty()) {
+        return;
+    }
+    std::string out(in.size(), '\0');
+    auto* in_data = reinterpret_cast<unsigned char*>(in.data());
+    auto* out_data = reinterpret_cast<unsigned char*>(out.data());
+    unsigned char cbc_block[buf_size];
+    std::memcpy(cbc_block, in_data, buf_size);
+    crypto.rijndael_init(
+        false, reinterpret_cast<unsigned char const*>(key.data()), key.size(), true, cbc_block);
+    for (size_t i = buf_size; i < in.size(); i += buf_size) {
+        crypto.rijndael_process(in_data + i, out_data + i);
+    }
+    crypto.rijndael_finalize();
+
+    size_t offset = 0;
+    for (auto* str: strings) {
+        if (str->empty()) {
+            continue;
+        }
+        auto begin = out.begin() + QIntC::to_offset(offset);
+        offset += (str->size() + buf_size - 1) / buf_size * buf_size;
+        auto end = out.begin() + QIntC::to_offset(offset);
+        auto last = static_cast<unsigned char>(*(end - 1));
+        if (last <= buf_size && std::all_of(end - last, end, [last](char c) {
+                return static_cast<unsigned char>(c) == last;
+            })) {
+            end -= last;
+        }
+        str->assign(begin + buf_size, end);
+    }
+}
+
 void
 QPDF::decryptString(std::string& str, QPDFObjGen og)
 {
-    if (!og.isIndirect()) {
+    StringDecrypter(this, og).decryptStrings({&str});
+}
+
+void
+QPDF::StringDecrypter::decryptStrings(std::vector<std::string*> const& strings)
+{
+    auto& m = qpdf->m;
+    if (strings.empty() || !og.isIndirect()) {
         return;
     }
     bool use_aes = false;
@@ -986,7 +1053,7 @@ QPDF::decryptString(std::string& str, QPDFObjGen og)
             break;
 
         default:
-            warn(m->c.damagedPDF(
+            qpdf->warn(m->c.damagedPDF(
                 "unknown encryption filter for strings (check /StrF in "
                 "/Encrypt dictionary); strings may be decrypted improperly"));
             // To avoid repeated warnings, reset cf_string.  Assume we'd want to use AES if V == 4.
@@ -997,24 +1064,24 @@ QPDF::decryptString(std::string& str, QPDFObjGen og)
     }
 
     std::string key = getKeyForObject(m->encp, og, use_aes);
+    // Strings are usually short, so creating a crypto implementation for each of them would cost
+    // more than decrypting them. Reuse one for all strings in the file.
+    auto& crypto = m->encp->string_crypto;
+    if (!crypto) {
+        crypto = QPDFCryptoProvider::getImpl();
+    }
     try {
         if (use_aes) {
             QTC::TC("qpdf", "QPDF_encryption aes decode string");
-            Pl_Buffer bufpl("decrypted string");
-            Pl_AES_PDF pl("aes decrypt string", &bufpl, false, key);
-            pl.writeString(str);
-            pl.finish();
-            str = bufpl.getString();
+            decrypt_aes_strings(*crypto, key, strings);
         } else {
             QTC::TC("qpdf", "QPDF_encryption rc4 decode string");
-            size_t vlen = str.length();
-            // Using std::shared_ptr guarantees that tmp will be freed even if rc4.process throws an
-            // exception.
-            auto tmp = QUtil::make_unique_cstr(str);
-            RC4 rc4(QUtil::unsigned_char_pointer(key), QIntC::to_int(key.length()));
-            auto data = QUtil::unsigned_char_pointer(tmp.get());
-            rc4.process(data, vlen, data);
-            str = std::string(tmp.get(), vlen);
+            for (auto* str: strings) {
+                auto data = reinterpret_cast<unsigned char*>(str->data());
+                crypto->RC4_init(QUtil::unsigned_char_pointer(key), QIntC::to_int(key.length()));
+                crypto->RC4_process(data, str->size(), data);
+                crypto->RC4_finalize();
+            }
         }
     } catch (QPDFExc&) {
         throw;
@@ -1112,8 +1179,18 @@ QPDF::decryptStream(
     }
     std::string key = getKeyForObject(encp, og, use_aes);
     if (use_aes) {
-        decrypt_pipeline =
-            std::make_unique<Pl_AES_PDF>("AES stream decryption", pipeline, false, key);
+        // Reuse one crypto implementation for all streams unless it is still in use by the
+        // decryption pipeline of another stream.
+        auto& crypto = encp->stream_crypto;
+        if (!crypto) {
+            crypto = QPDFCryptoProvider::getImpl();
+        }
+        decrypt_pipeline = std::make_unique<Pl_AES_PDF>(
+            "AES stream decryption",
+            pipeline,
+            false,
+            key,
+            crypto.use_count() == 1 ? crypto : QPDFCryptoProvider::getImpl());
     } else {
         decrypt_pipeline = std::make_unique<Pl_RC4>("RC4 stream decryption", pipeline, key);
     }
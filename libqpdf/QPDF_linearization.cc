@@ -106,8 +106,7 @@ Lin::ObjUser::operator<(ObjUser const& rhs) const
     return false;
 }
 
-Lin::UpdateObjectMapsFrame::UpdateObjectMapsFrame(
-    ObjUser const& ou, QPDFObjectHandle oh, bool top) :
+Lin::UpdateObjectMapsFrame::UpdateObjectMapsFrame(size_t ou, QPDFObjectHandle oh, bool top) :
     ou(ou),
     oh(oh),
     top(top)
@@ -137,7 +136,7 @@ Lin::optimize_internal(
     bool allow_changes,
     std::function<int(QPDFObjectHandle&)> skip_stream_parameters)
 {
-    if (!obj_user_to_objects_.empty()) {
+    if (!obj_users_.empty()) {
         // already optimized
         return;
     }
@@ -157,6 +156,9 @@ Lin::optimize_internal(
     m->pages.pushInheritedAttributesToPage(allow_changes, false);
     // Traverse pages
 
+    visited_in_.assign(QIntC::to_size(m->obj_cache.max_id()) + 1, 0);
+    traversal_ = 0;
+
     size_t n = 0;
     for (auto const& page: m->pages) {
         updateObjectMaps(ObjUser(ObjUser::ou_page, n), page, skip_stream_parameters);
@@ -185,12 +187,24 @@ Lin::optimize_internal(
         }
     }
 
-    ObjUser root_ou = ObjUser(ObjUser::ou_root);
-    auto root_og = root.id_gen();
-    obj_user_to_objects_[root_ou].insert(root_og);
-    object_to_obj_users_[root_og].insert(root_ou);
+    obj_user_objects_.at(addObjUser(ObjUser(ObjUser::ou_root))).emplace_back(root.id_gen());
+
+    visited_in_.clear();
+    visited_in_.shrink_to_fit();
 
     filterCompressedObjects(object_stream_data);
+    indexObjectUsers();
+}
+
+size_t
+Lin::addObjUser(ObjUser const& ou)
+{
+    auto [it, inserted] = obj_user_index_.try_emplace(ou, obj_users_.size());
+    if (inserted) {
+        obj_users_.emplace_back(ou);
+        obj_user_objects_.emplace_back();
+    }
+    return it->second;
 }
 
 void
@@ -199,11 +213,29 @@ Lin::updateObjectMaps(
     QPDFObjectHandle first_oh,
     std::function<int(QPDFObjectHandle&)> skip_stream_parameters)
 {
-    QPDFObjGen::set visited;
+    // Objects are marked as visited by recording the traversal number against their object id.
+    // Objects with a non-zero generation are rare, and are tracked separately so that two objects
+    // with the same id can't be mistaken for one another.
+    ++traversal_;
+    QPDFObjGen::set visited_other;
+    auto visit = [this, &visited_other](QPDFObjGen og) {
+        auto id = static_cast<size_t>(og.getObj());
+        if (og.getGen() != 0) {
+            return visited_other.add(og);
+        }
+        if (id >= visited_in_.size()) {
+            visited_in_.resize(id + 1, 0);
+        }
+        if (visited_in_[id] == traversal_) {
+            return false;
+        }
+        visited_in_[id] = traversal_;
+        return true;
+    };
+
     std::vector<UpdateObjectMapsFrame> pending;
-    pending.emplace_back(first_ou, first_oh, true);
+    pending.emplace_back(addObjUser(first_ou), first_oh, true);
     // Traverse the object tree from this point taking care to avoid crossing page boundaries.
-    std::unique_ptr<ObjUser> thumb_ou;
     while (!pending.empty()) {
         auto cur = pending.back();
         pending.pop_back();
@@ -219,12 +251,11 @@ Lin::updateObjectMaps(
 
         if (cur.oh.indirect()) {
             QPDFObjGen og(cur.oh.getObjGen());
-            if (!visited.add(og)) {
+            if (!visit(og)) {
                 QTC::TC("qpdf", "QPDF opt loop detected");
                 continue;
             }
-            obj_user_to_objects_[cur.ou].insert(og);
-            object_to_obj_users_[og].insert(cur.ou);
+            obj_user_objects_[cur.ou].emplace_back(og);
         }
 
         if (cur.oh.isArray()) {
@@ -250,8 +281,9 @@ Lin::updateObjectMaps(
                 if (is_page_node && (key == "/Thumb")) {
                     // Traverse page thumbnail dictionaries as a special case. There can only ever
                     // be one /Thumb key on a page, and we see at most one page node per call.
-                    thumb_ou = std::make_unique<ObjUser>(ObjUser::ou_thumb, cur.ou.pageno);
-                    pending.emplace_back(*thumb_ou, dict.getKey(key), false);
+                    auto thumb_ou = addObjUser(
+                        ObjUser(ObjUser::ou_thumb, obj_users_[cur.ou].pageno));
+                    pending.emplace_back(thumb_ou, dict.getKey(key), false);
                 } else if (is_page_node && (key == "/Parent")) {
                     // Don't traverse back up the page tree
                 } else if (
@@ -273,37 +305,17 @@ Lin::filterCompressedObjects(std::map<int, int> const& object_stream_data)
         return;
     }
 
-    // Transform object_to_obj_users and obj_user_to_objects so that they refer only to uncompressed
-    // objects.  If something is a user of a compressed object, then it is really a user of the
-    // object stream that contains it.
-
-    std::map<ObjUser, std::set<QPDFObjGen>> t_obj_user_to_objects;
-    std::map<QPDFObjGen, std::set<ObjUser>> t_object_to_obj_users;
-
-    for (auto const& [ou, ogs]: obj_user_to_objects_) {
-        for (auto const& og: ogs) {
-            auto i2 = object_stream_data.find(og.getObj());
-            if (i2 == object_stream_data.end()) {
-                t_obj_user_to_objects[ou].insert(og);
-            } else {
-                t_obj_user_to_objects[ou].insert({i2->second, 0});
-            }
-        }
-    }
+    // Transform obj_user_objects so that it refers only to uncompressed objects.  If something is a
+    // user of a compressed object, then it is really a user of the object stream that contains it.
 
-    for (auto const& [og, ous]: object_to_obj_users_) {
-        for (auto const& ou: ous) {
+    for (auto& ogs: obj_user_objects_) {
+        for (auto& og: ogs) {
             auto i2 = object_stream_data.find(og.getObj());
-            if (i2 == object_stream_data.end()) {
-                t_object_to_obj_users[og].insert(ou);
-            } else {
-                t_object_to_obj_users[{i2->second, 0}].insert(ou);
+            if (i2 != object_stream_data.end()) {
+                og = QPDFObjGen(i2->second, 0);
             }
         }
     }
-
-    obj_user_to_objects_ = std::move(t_obj_user_to_objects);
-    object_to_obj_users_ = std::move(t_object_to_obj_users);
 }
 
 void
@@ -313,40 +325,73 @@ Lin::filterCompressedObjects(QPDFWriter::ObjTable const& obj)
         return;
     }
 
-    // Transform object_to_obj_users and obj_user_to_objects so that they refer only to uncompressed
-    // objects.  If something is a user of a compressed object, then it is really a user of the
-    // object stream that contains it.
+    // Transform obj_user_objects so that it refers only to uncompressed objects.  If something is a
+    // user of a compressed object, then it is really a user of the object stream that contains it.
 
-    std::map<ObjUser, std::set<QPDFObjGen>> t_obj_user_to_objects;
-    std::map<QPDFObjGen, std::set<ObjUser>> t_object_to_obj_users;
+    for (auto& ogs: obj_user_objects_) {
+        std::erase_if(ogs, [&obj](auto const& og) { return !obj.contains(og); });
+        for (auto& og: ogs) {
+            if (auto i2 = obj[og].object_stream; i2 > 0) {
+                og = QPDFObjGen(i2, 0);
+            }
+        }
+    }
+}
 
-    for (auto const& [ou, ogs]: obj_user_to_objects_) {
+void
+Lin::indexObjectUsers()
+{
+    // Sort each object user's objects, dropping duplicates introduced by filterCompressedObjects,
+    // and build the reverse mapping from objects to their users.
+    std::vector<std::pair<QPDFObjGen, size_t>> uses;
+    for (size_t ou = 0; ou < obj_user_objects_.size(); ++ou) {
+        auto& ogs = obj_user_objects_[ou];
+        std::sort(ogs.begin(), ogs.end());
+        ogs.erase(std::unique(ogs.begin(), ogs.end()), ogs.end());
+        ogs.shrink_to_fit();
         for (auto const& og: ogs) {
-            if (obj.contains(og)) {
-                if (auto const& i2 = obj[og].object_stream; i2 <= 0) {
-                    t_obj_user_to_objects[ou].insert(og);
-                } else {
-                    t_obj_user_to_objects[ou].insert(QPDFObjGen(i2, 0));
-                }
-            }
+            uses.emplace_back(og, ou);
         }
     }
+    std::sort(uses.begin(), uses.end());
 
-    for (auto const& [og, ous]: object_to_obj_users_) {
-        if (obj.contains(og)) {
-            // Loop over obj_users.
-            for (auto const& ou: ous) {
-                if (auto i2 = obj[og].object_stream; i2 <= 0) {
-                    t_object_to_obj_users[og].insert(ou);
-                } else {
-                    t_object_to_obj_users[{i2, 0}].insert(ou);
-                }
-            }
+    used_objects_.clear();
+    object_users_start_.clear();
+    object_users_.clear();
+    object_users_.reserve(uses.size());
+    for (auto const& [og, ou]: uses) {
+        if (used_objects_.empty() || used_objects_.back() != og) {
+            used_objects_.emplace_back(og);
+            object_users_start_.emplace_back(object_users_.size());
         }
+        object_users_.emplace_back(ou);
     }
+    object_users_start_.emplace_back(object_users_.size());
+}
 
-    obj_user_to_objects_ = std::move(t_obj_user_to_objects);
-    object_to_obj_users_ = std::move(t_object_to_obj_users);
+bool
+Lin::hasObjects(ObjUser const& ou) const
+{
+    return !objectsUsedBy(ou).empty();
+}
+
+std::vector<QPDFObjGen> const&
+Lin::objectsUsedBy(ObjUser const& ou) const
+{
+    static const std::vector<QPDFObjGen> none;
+    auto it = obj_user_index_.find(ou);
+    return it == obj_user_index_.end() ? none : obj_user_objects_[it->second];
+}
+
+size_t
+Lin::countObjUsers(QPDFObjGen og) const
+{
+    auto it = std::lower_bound(used_objects_.begin(), used_objects_.end(), og);
+    if (it == used_objects_.end() || *it != og) {
+        return 0;
+    }
+    auto i = static_cast<size_t>(it - used_objects_.begin());
+    return object_users_start_[i + 1] - object_users_start_[i];
 }
 
 void
@@ -434,7 +479,7 @@ Lin::linearized()
 }
 
 void
-Lin::readLinearizationData()
+Lin::readLinearizationData(bool check_npages)
 {
     util::assertion(
         linearized(), "called readLinearizationData for file that is not linearized" //
@@ -479,9 +524,11 @@ Lin::readLinearizationData()
     // Store linearization parameter data
 
     // Various places in the code use linp.npages, which is initialized from N, to pre-allocate
-    // memory, so make sure it's accurate and bail right now if it's not.
+    // memory, so make sure it's accurate and bail right now if it's not. When only reading the hint
+    // tables to find pages, the pages tree is not traversed; the caller checks N against /Count of
+    // the root of the pages tree instead.
     no_ci_stop_if(
-        N != pages.size(),
+        check_npages && N != pages.size(),
         "/N does not match number of pages",
         "linearization dictionary" //
     );
@@ -541,6 +588,240 @@ Lin::readLinearizationData()
     }
 }
 
+size_t
+QPDF::getLinearizedPageCount()
+{
+    return m->lin.page_count();
+}
+
+QPDFObjectHandle
+QPDF::getLinearizedPage(size_t pageno)
+{
+    return m->lin.page(pageno);
+}
+
+bool
+Lin::readPageHints()
+{
+    if (page_hints_read_) {
+        return !hint_page_ids_.empty();
+    }
+    page_hints_read_ = true;
+    try {
+        if (!linearized()) {
+            return false;
+        }
+        readLinearizationData(false);
+    } catch (std::exception&) {
+        // Problems with the linearization data are reported by checkLinearization. Here they just
+        // mean that pages have to be found through the pages tree.
+        return false;
+    }
+    if (linp_.npages == 0 || Integer(qpdf.getRoot()["/Pages"]["/Count"]) != linp_.npages) {
+        return false;
+    }
+
+    // The objects of each page after the first are numbered consecutively in page order, starting
+    // with the page object, and are followed by the shared objects of those pages (part 8). If
+    // there are no such shared objects, the objects of the second page start at object 1.
+    auto const& t = page_offset_hints_;
+    long long id = 1;
+    if (shared_object_hints_.nshared_total > shared_object_hints_.nshared_first_page) {
+        id = shared_object_hints_.first_shared_obj;
+        for (size_t i = 1; i < t.entries.size(); ++i) {
+            id -= t.min_nobjects + t.entries[i].delta_nobjects;
+        }
+    }
+    std::vector<int> ids{linp_.first_page_object};
+    std::vector<qpdf_offset_t> offsets{0};
+    qpdf_offset_t offset = 0;
+    for (size_t i = 1; i < t.entries.size(); ++i) {
+        if (id < 1 || id > std::numeric_limits<int>::max()) {
+            return false;
+        }
+        ids.emplace_back(static_cast<int>(id));
+        offsets.emplace_back(offset);
+        id += t.min_nobjects + t.entries[i].delta_nobjects;
+        offset += t.min_page_length + t.entries[i].delta_page_length;
+    }
+    for (auto page_id: ids) {
+        hint_pages_.insert(page_id);
+    }
+    hint_page_ids_ = std::move(ids);
+    hint_page_offsets_ = std::move(offsets);
+
+    // The objects of the first page include the objects it shares with other pages. The first
+    // nshared_first_page entries of the shared object hint table are groups of consecutive objects
+    // starting with the first page object. Find the groups that other pages refer to.
+    auto const& so = shared_object_hints_;
+    auto const first_page_end = static_cast<long long>(linp_.first_page_object) + t.min_nobjects +
+        t.entries[0].delta_nobjects;
+    if (so.nshared_first_page < 0 || so.nshared_total < so.nshared_first_page ||
+        toS(so.nshared_total) != so.entries.size()) {
+        return true;
+    }
+    std::vector<std::pair<int, int>> groups; // first object and number of objects
+    long long obj = linp_.first_page_object;
+    for (size_t i = 0; i < toS(so.nshared_first_page); ++i) {
+        auto n = so.entries[i].nobjects_minus_one + 1LL;
+        if (n < 1 || obj + n > first_page_end) {
+            return true;
+        }
+        groups.emplace_back(static_cast<int>(obj), static_cast<int>(n));
+        obj += n;
+    }
+    for (size_t i = 1; i < t.entries.size(); ++i) {
+        for (auto idx: t.entries[i].shared_identifiers) {
+            if (idx < 0 || idx >= so.nshared_total) {
+                first_page_shared_ = ObjIdSet();
+                return true;
+            }
+            if (idx < so.nshared_first_page) {
+                auto [first, n] = groups[toS(idx)];
+                for (int j = 0; j < n; ++j) {
+                    first_page_shared_.insert(first + j);
+                }
+            }
+        }
+    }
+    first_page_shared_valid_ = true;
+    return true;
+}
+
+size_t
+Lin::page_count()
+{
+    return readPageHints() ? hint_page_ids_.size() : 0;
+}
+
+QPDFObjectHandle
+Lin::page(size_t pageno)
+{
+    if (!readPageHints() || pageno >= hint_page_ids_.size()) {
+        return QPDFObjectHandle::newNull();
+    }
+
+    // Make sure that the object the hint tables point to is an uncompressed page object at the
+    // expected offset. Offsets of pages after the first are checked relative to the second page.
+    auto uncompressed_offset = [this](QPDFObjGen og) -> qpdf_offset_t {
+        if (!m->xref_table.contains(og) || m->xref_table[og].getType() != 1) {
+            return -1;
+        }
+        return m->xref_table[og].getOffset();
+    };
+    QPDFObjGen og(hint_page_ids_[pageno], 0);
+    auto offset = uncompressed_offset(og);
+    if (offset < 0) {
+        return QPDFObjectHandle::newNull();
+    }
+    if (pageno == 0) {
+        if (offset != adjusted_offset(page_offset_hints_.first_page_offset)) {
+            return QPDFObjectHandle::newNull();
+        }
+    } else {
+        auto base = uncompressed_offset({hint_page_ids_[1], 0});
+        if (base < 0 || offset - base != hint_page_offsets_[pageno]) {
+            return QPDFObjectHandle::newNull();
+        }
+    }
+    auto page = qpdf.getObject(og);
+    if (!page.isDictionaryOfType("/Page")) {
+        return QPDFObjectHandle::newNull();
+    }
+
+    // Callers use the page without pushing inherited attributes down from the pages tree, which
+    // would require traversing all of it, so reject pages that inherit any attributes. Also make
+    // sure that the page is actually reachable from the root of the pages tree and that it is at
+    // the position in the pages tree that the hint tables give for it.
+    auto root_pages = qpdf.getRoot()["/Pages"];
+    QPDFObjGen::set seen;
+    auto node = page;
+    size_t position = 0;
+    static uint32_t constexpr max_level = 100;
+    for (uint32_t level = 0; level < max_level; ++level) {
+        auto parent = node["/Parent"];
+        if (!parent.isDictionaryOfType("/Pages") || !seen.add(parent)) {
+            return QPDFObjectHandle::newNull();
+        }
+        for (auto const& key: {"/MediaBox", "/CropBox", "/Resources", "/Rotate"}) {
+            if (parent.hasKey(key)) {
+                return QPDFObjectHandle::newNull();
+            }
+        }
+        auto kid = kid_position(parent, node.getObjGen());
+        if (!kid) {
+            return QPDFObjectHandle::newNull();
+        }
+        position += *kid;
+        if (parent.isSameObjectAs(root_pages)) {
+            if (position != pageno) {
+                return QPDFObjectHandle::newNull();
+            }
+            pages.used_hints();
+            return page;
+        }
+        node = parent;
+    }
+    return QPDFObjectHandle::newNull();
+}
+
+// Return the number of pages that come before kid among the kids of the pages tree node parent, or
+// nothing if kid is not a kid of parent or the node's /Kids and /Count are inconsistent. Kids that
+// the hint tables identify as pages are counted without reading them so that finding a page in a
+// large, flat pages tree does not require reading all pages that come before it.
+std::optional<size_t>
+Lin::kid_position(QPDFObjectHandle parent, QPDFObjGen kid)
+{
+    auto [it, inserted] = kid_positions_.try_emplace(parent.getObjGen());
+    auto& positions = it->second;
+    if (inserted) {
+        size_t count = 0;
+        bool valid = true;
+        for (auto const& k: parent["/Kids"].as_array()) {
+            auto og = k.getObjGen();
+            if (!k.indirect() || !positions.try_emplace(og, count).second) {
+                valid = false;
+                break;
+            }
+            if (og.getGen() == 0 && hint_pages_.contains(og.getObj())) {
+                ++count;
+            } else if (k.isDictionaryOfType("/Pages")) {
+                Integer n = k["/Count"];
+                if (!n || n < 0) {
+                    valid = false;
+                    break;
+                }
+                count += n.value<size_t>();
+            } else {
+                ++count;
+            }
+        }
+        if (!valid || Integer(parent["/Count"]) != count) {
+            positions.clear();
+        }
+    }
+    if (auto position = positions.find(kid); position != positions.end()) {
+        return position->second;
+    }
+    return std::nullopt;
+}
+
+bool
+Lin::page_private(size_t pageno, QPDFObjGen og)
+{
+    if (!readPageHints() || pageno >= hint_page_ids_.size() || og.getGen() != 0) {
+        return false;
+    }
+    auto const& t = page_offset_hints_;
+    auto first = hint_page_ids_[pageno];
+    if (og.getObj() < first ||
+        og.getObj() - first >= t.min_nobjects + t.entries[pageno].delta_nobjects) {
+        return false;
+    }
+    // The objects of the first page include the objects it shares with other pages.
+    return pageno > 0 || (first_page_shared_valid_ && !first_page_shared_.contains(og.getObj()));
+}
+
 Dictionary
 Lin::readHintStream(Pipeline& pl, qpdf_offset_t offset, size_t length)
 {
@@ -786,12 +1067,12 @@ qpdf_offset_t
 Lin::maxEnd(ObjUser const& ou)
 {
     no_ci_stop_if(
-        !obj_user_to_objects_.contains(ou),
+        !hasObjects(ou),
         "no entry in object user table for requested object user" //
     );
 
     qpdf_offset_t end = 0;
-    for (auto const& og: obj_user_to_objects_[ou]) {
+    for (auto const& og: objectsUsedBy(ou)) {
         no_ci_stop_if(
             !m->obj_cache.contains(og), "unknown object referenced in object user table" //
         );
@@ -1226,7 +1507,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     // actual offsets and lengths are not computed here, but anything related to object ordering is.
 
     util::assertion(
-        !object_to_obj_users_.empty(),
+        !used_objects_.empty(),
         "INTERNAL ERROR: QPDF::calculateLinearizationData called before optimize()" //
     );
     // Note that we can't call optimize here because we don't know whether it should be called
@@ -1318,7 +1599,8 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     std::set<QPDFObjGen> lc_outlines;
     std::set<QPDFObjGen> lc_root;
 
-    for (auto& [og, ous]: object_to_obj_users_) {
+    for (size_t i = 0; i < used_objects_.size(); ++i) {
+        auto const& og = used_objects_[i];
         bool in_open_document = false;
         bool in_first_page = false;
         int other_pages = 0;
@@ -1327,7 +1609,8 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         bool in_outlines = false;
         bool is_root = false;
 
-        for (auto const& ou: ous) {
+        for (auto j = object_users_start_[i]; j < object_users_start_[i + 1]; ++j) {
+            auto const& ou = obj_users_[object_users_[j]];
             switch (ou.ou_type) {
             case ObjUser::ou_trailer_key:
                 if (ou.key == "/Encrypt") {
@@ -1490,11 +1773,11 @@ Lin::calculateLinearizationData(T const& object_stream_data)
 
         ObjUser ou(ObjUser::ou_page, i);
         no_ci_stop_if(
-            !obj_user_to_objects_.contains(ou),
+            !hasObjects(ou),
             "found unreferenced page while calculating linearization data" //
         );
 
-        for (auto const& og: obj_user_to_objects_[ou]) {
+        for (auto const& og: objectsUsedBy(ou)) {
             if (lc_other_page_private.erase(og)) {
                 part7_.emplace_back(qpdf.getObject(og));
                 ++c_page_offset_data_.entries.at(i).nobjects;
@@ -1523,7 +1806,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
     // we throw all remaining objects in arbitrary order.
 
     // Place the pages tree.
-    auto& pages_ogs = obj_user_to_objects_[{ObjUser::ou_root_key, "/Pages"}];
+    auto const& pages_ogs = objectsUsedBy({ObjUser::ou_root_key, "/Pages"});
     no_ci_stop_if(
         pages_ogs.empty(), "found empty pages tree while calculating linearization data" //
     );
@@ -1548,7 +1831,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
             // there's nothing to prevent it from having been in some set other than
             // lc_thumbnail_private.
         }
-        for (auto const& og: obj_user_to_objects_[{ObjUser::ou_thumb, i}]) {
+        for (auto const& og: objectsUsedBy({ObjUser::ou_thumb, i})) {
             if (lc_thumbnail_private.erase(og)) {
                 part9_.emplace_back(qpdf.getObject(og));
             }
@@ -1579,7 +1862,7 @@ Lin::calculateLinearizationData(T const& object_stream_data)
 
     size_t num_placed =
         part4_.size() + part6_.size() + part7_.size() + part8_.size() + part9_.size();
-    size_t num_wanted = object_to_obj_users_.size();
+    size_t num_wanted = used_objects_.size();
     no_ci_stop_if(
         // This can happen with damaged files, e.g. if the root is part of the the pages tree.
         num_placed != num_wanted,
@@ -1630,12 +1913,12 @@ Lin::calculateLinearizationData(T const& object_stream_data)
         CHPageOffsetEntry& pe = c_page_offset_data_.entries.at(i);
         ObjUser ou(ObjUser::ou_page, i);
         no_ci_stop_if(
-            !obj_user_to_objects_.contains(ou),
+            !hasObjects(ou),
             "found unreferenced page while calculating linearization data" //
         );
 
-        for (auto const& og: obj_user_to_objects_[ou]) {
-            if (object_to_obj_users_[og].size() > 1 && obj_to_index.contains(og.getObj())) {
+        for (auto const& og: objectsUsedBy(ou)) {
+            if (countObjUsers(og) > 1 && obj_to_index.contains(og.getObj())) {
                 int idx = obj_to_index[og.getObj()];
                 ++pe.nshared_objects;
                 pe.shared_identifiers.push_back(idx);
@@ -16,9 +16,12 @@
 
 #include <array>
 #include <atomic>
+#include <algorithm>
 #include <cstring>
+#include <future>
 #include <limits>
 #include <map>
+#include <thread>
 #include <vector>
 
 using namespace qpdf;
@@ -252,6 +255,7 @@ Objects::parse(char const* password)
         }
         try {
             read_xref(xref_offset);
+            last_xref_offset_ = xref_offset;
         } catch (QPDFExc&) {
             throw;
         } catch (std::exception& e) {
@@ -309,6 +313,252 @@ Objects::setTrailer(QPDFObjectHandle obj)
     m->trailer = obj;
 }
 
+namespace
+{
+    // Helper for Objects::reconstruct_xref. The recovery loop examines the first token of every
+    // line of the file, which is very slow for large files. XRefScanner scans a range of an
+    // in-memory window of the file and reports a superset of the positions at which the recovery
+    // loop could find anything of interest: the starts of tokens that may be the start of "n g
+    // obj", "trailer" or "startxref", and of tokens that may contain an end of line, since how the
+    // recovery loop continues after those depends on how they are parsed. Every other token ends
+    // before the first end of line following its start. End of line characters are located with
+    // memchr, which is vectorized on all common platforms.
+    class XRefScanner
+    {
+      public:
+        // If at_eof is false, the file continues past the end of data.
+        XRefScanner(std::string_view data, bool at_eof) :
+            data(data),
+            at_eof(at_eof)
+        {
+        }
+
+        // Return, in increasing order, the candidates among the lines starting in [from, to). from
+        // must be zero or the position of a byte not at the start of the file, in which case
+        // data[from - 1] must be valid.
+        std::vector<size_t>
+        scan(size_t from, size_t to)
+        {
+            std::vector<size_t> result;
+            auto start = from == 0 ? 0 : from - 1;
+            cr = {'\r', start, find(start, '\r')};
+            lf = {'\n', start, find(start, '\n')};
+            for (auto line = from == 0 ? 0 : next_line(start); line < to;) {
+                auto token = skip_space(line);
+                if (token == data.size()) {
+                    if (!at_eof) {
+                        // The token starts in a later window.
+                        result.emplace_back(line);
+                    }
+                    break;
+                }
+                if (candidate(token)) {
+                    result.emplace_back(token);
+                }
+                line = next_line(token);
+            }
+            return result;
+        }
+
+      private:
+        size_t
+        find(size_t pos, char ch) const
+        {
+            auto p = static_cast<char const*>(memchr(data.data() + pos, ch, data.size() - pos));
+            return p ? static_cast<size_t>(p - data.data()) : data.size();
+        }
+
+        // The position of the first occurrence of ch at or after from.
+        struct Next
+        {
+            char ch;
+            size_t from;
+            size_t at;
+        };
+
+        // Return the position of the first occurrence of next.ch at or after pos, updating next.
+        // Only the part of data not already covered by next is searched.
+        size_t
+        find(size_t pos, Next& next) const
+        {
+            if (pos < next.from) {
+                auto p = static_cast<char const*>(
+                    memchr(data.data() + pos, next.ch, next.from - pos));
+                if (p) {
+                    next.at = static_cast<size_t>(p - data.data());
+                }
+                next.from = pos;
+            } else if (next.at < pos) {
+                next = {next.ch, pos, find(pos, next.ch)};
+            }
+            return next.at;
+        }
+
+        // Return the position of the first end of line character at or after pos.
+        size_t
+        find_eol(size_t pos)
+        {
+            return std::min(find(pos, cr), find(pos, lf));
+        }
+
+        // Return the start of the line following the first end of line at or after pos, as
+        // InputSource::findAndSkipNextEOL does.
+        size_t
+        next_line(size_t pos)
+        {
+            pos = find_eol(pos);
+            while (pos < data.size() && (data[pos] == '\r' || data[pos] == '\n')) {
+                ++pos;
+            }
+            return pos;
+        }
+
+        static bool
+        is_space(char ch)
+        {
+            return ch == '\0' || util::is_space(ch);
+        }
+
+        static bool
+        is_delimiter(char ch)
+        {
+            return is_space(ch) || ch == '/' || ch == '(' || ch == ')' || ch == '{' || ch == '}' ||
+                ch == '<' || ch == '>' || ch == '[' || ch == ']' || ch == '%';
+        }
+
+        // Return the position of the first character at or after pos that is neither white space
+        // nor part of a comment, or data.size() if there is none.
+        size_t
+        skip_space(size_t pos)
+        {
+            while (pos < data.size()) {
+                if (is_space(data[pos])) {
+                    ++pos;
+                } else if (data[pos] == '%') {
+                    pos = find_eol(pos);
+                } else {
+                    break;
+                }
+            }
+            return pos;
+        }
+
+        // Return false if the text at pos is known not to start with keyword. Text cut off by the
+        // end of the window is assumed to match.
+        bool
+        may_match(size_t pos, std::string_view keyword) const
+        {
+            auto available = data.substr(pos, keyword.size());
+            return keyword.starts_with(available) && (available.size() == keyword.size() || !at_eof);
+        }
+
+        // Return false if the tokens starting at pos are known not to be "n g obj".
+        bool
+        may_be_object(size_t pos)
+        {
+            for (int i = 0; i < 2; ++i) {
+                if (data[pos] == '+' || data[pos] == '-') {
+                    ++pos;
+                }
+                auto digits = pos;
+                while (pos < data.size() && util::is_digit(data[pos])) {
+                    ++pos;
+                }
+                if (pos == data.size()) {
+                    return !at_eof;
+                }
+                if (pos == digits || !is_delimiter(data[pos])) {
+                    return false;
+                }
+                pos = skip_space(pos);
+                if (pos == data.size()) {
+                    return !at_eof;
+                }
+            }
+            return may_match(pos, "obj");
+        }
+
+        // Return true if the recovery loop needs to examine the token starting at pos.
+        bool
+        candidate(size_t pos)
+        {
+            switch (data[pos]) {
+            case '(':
+                // Strings may span several lines.
+                return true;
+
+            case '<':
+                // So may hex strings, but not dictionary delimiters.
+                return pos + 1 == data.size() ? !at_eof : data[pos + 1] != '<';
+
+            case 't':
+                return may_match(pos, "trailer");
+
+            case 's':
+                return may_match(pos, "startxref");
+
+            case '+':
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return may_be_object(pos);
+
+            default:
+                return false;
+            }
+        }
+
+        std::string_view data;
+        bool at_eof;
+        Next cr{'\r', 0, 0};
+        Next lf{'\n', 0, 0};
+    };
+
+    // Size of the windows of the file read by Objects::reconstruct_xref.
+    constexpr size_t xref_window_size = 16 * 1024 * 1024;
+
+    // Return the XRefScanner candidates among the lines starting at or after begin in a window of
+    // the file. begin must be zero or one, in which case data[0] is the last byte of the previous
+    // window. Large windows are split into ranges that are scanned in parallel.
+    std::vector<size_t>
+    scan_xref_window(std::string_view data, size_t begin, bool at_eof)
+    {
+        // Smallest range worth scanning in a separate thread.
+        static constexpr size_t min_range_size = 1024 * 1024;
+
+        auto n = std::min(
+            size_t(std::max(1U, std::thread::hardware_concurrency())),
+            (data.size() - begin) / min_range_size);
+        if (n < 2) {
+            return XRefScanner(data, at_eof).scan(begin, data.size());
+        }
+        auto range_size = (data.size() - begin) / n;
+        std::vector<std::future<std::vector<size_t>>> ranges;
+        ranges.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            auto from = begin + i * range_size;
+            auto to = i + 1 == n ? data.size() : from + range_size;
+            ranges.emplace_back(std::async(std::launch::async, [data, at_eof, from, to]() {
+                return XRefScanner(data, at_eof).scan(from, to);
+            }));
+        }
+        std::vector<size_t> result;
+        for (auto& range: ranges) {
+            auto candidates = range.get();
+            result.insert(result.end(), candidates.begin(), candidates.end());
+        }
+        return result;
+    }
+} // namespace
+
 void
 Objects::reconstruct_xref(QPDFExc& e, bool found_startxref)
 {
@@ -352,10 +602,11 @@ Objects::reconstruct_xref(QPDFExc& e, bool found_startxref)
 
     m->file->seek(0, SEEK_END);
     qpdf_offset_t eof = m->file->tell();
-    m->file->seek(0, SEEK_SET);
     // Don't allow very long tokens here during recovery. All the interesting tokens are covered.
     static size_t const MAX_LEN = 10;
-    while (m->file->tell() < eof) {
+    // Examine the first token at or after offset and return the start of the following line.
+    auto examine = [&](qpdf_offset_t offset) {
+        m->file->seek(offset, SEEK_SET);
         QPDFTokenizer::Token t1 = m->objects.readToken(*m->file, MAX_LEN);
         qpdf_offset_t token_start = m->file->tell() - toO(t1.getValue().length());
         if (t1.isInteger()) {
@@ -379,6 +630,29 @@ Objects::reconstruct_xref(QPDFExc& e, bool found_startxref)
         }
         check_warnings();
         m->file->findAndSkipNextEOL();
+        return m->file->tell();
+    };
+    // Conceptually, examine the start of every line of the file in turn. Lines for which
+    // XRefScanner can tell that examine would find nothing are skipped. As the candidates are
+    // processed in file order and candidates before the line examine would have reached next are
+    // ignored, the outcome is exactly the same as examining every line.
+    qpdf_offset_t next = 0;
+    std::string window;
+    for (qpdf_offset_t start = 0; start < eof && next < eof;) {
+        // Include the last byte of the previous window to allow the scan to find the start of the
+        // first line in this window.
+        auto from = start > 0 ? start - 1 : 0;
+        auto len = std::min(eof - from, toO(xref_window_size) + start - from);
+        if (m->file->read(window, toS(len), from) <= toS(start - from)) {
+            break;
+        }
+        auto at_eof = from + toO(window.size()) >= eof;
+        for (auto candidate: scan_xref_window(window, toS(start - from), at_eof)) {
+            if (auto pos = from + toO(candidate); pos >= next) {
+                next = examine(pos);
+            }
+        }
+        start = from + toO(window.size());
     }
 
     if (!found_startxref && !startxrefs.empty() && !found_objects.empty() &&
@@ -550,7 +824,11 @@ Objects::read_xref(qpdf_offset_t xref_offset, bool in_stream_recovery)
         m->file->read(buf, sizeof(buf) - 1);
         // The PDF spec says xref must be followed by a line terminator, but files exist in the wild
         // where it is terminated by arbitrary whitespace.
-        if ((strncmp(buf, "xref", 4) == 0) && util::is_space(buf[4])) {
+        bool is_table = (strncmp(buf, "xref", 4) == 0) && util::is_space(buf[4]);
+        if (visited.size() == 1) {
+            last_xref_stream_ = !is_table;
+        }
+        if (is_table) {
             if (skipped_space) {
                 warn(damagedPDF("", -1, "extraneous whitespace seen before xref"));
             }
@@ -581,10 +859,10 @@ Objects::read_xref(qpdf_offset_t xref_offset, bool in_stream_recovery)
     int size = m->trailer.getKey("/Size").getIntValueAsInt();
     int max_obj = 0;
     if (!m->xref_table.empty()) {
-        max_obj = m->xref_table.rbegin()->first.getObj();
+        max_obj = m->xref_table.max_id();
     }
     if (!m->deleted_objects.empty()) {
-        max_obj = std::max(max_obj, *(m->deleted_objects.rbegin()));
+        max_obj = std::max(max_obj, m->deleted_objects.max());
     }
     if (size < 1 || (size - 1) != max_obj) {
         if (size == (max_obj + 2) && qpdf.getObject(max_obj + 1, 0).isStreamOfType("/XRef")) {
@@ -1225,6 +1503,7 @@ Objects::resolveXRefTable()
     bool may_change = !m->reconstructed_xref;
     for (auto& iter: m->xref_table) {
         if (isUnresolved(iter.first)) {
+            maybe_release();
             resolve(iter.first);
             if (may_change && m->reconstructed_xref) {
                 return false;
@@ -1246,6 +1525,7 @@ QPDF::fixDanglingReferences(bool force)
         m->objects.resolveXRefTable();
     }
     m->fixed_dangling_refs = true;
+    m->max_file_object_id = m->obj_cache.max_id();
 }
 
 size_t
@@ -1255,11 +1535,7 @@ QPDF::getObjectCount()
     // this purpose. After fixDanglingReferences is called, all objects in the xref table will also
     // be in obj_cache.
     fixDanglingReferences();
-    QPDFObjGen og;
-    if (!m->obj_cache.empty()) {
-        og = (*(m->obj_cache.rbegin())).first;
-    }
-    return QIntC::to_size(og.getObj());
+    return QIntC::to_size(m->obj_cache.max_id());
 }
 
 std::vector<QPDFObjectHandle>
@@ -1659,7 +1935,9 @@ std::shared_ptr<QPDFObject> const&
 Objects::resolve(QPDFObjGen og)
 {
     if (!isUnresolved(og)) {
-        return m->obj_cache[og].object;
+        auto& cache = m->obj_cache[og];
+        cache_hit(cache);
+        return cache.object;
     }
 
     if (m->resolving.contains(og)) {
@@ -1676,12 +1954,23 @@ Objects::resolve(QPDFObjGen og)
         try {
             switch (entry.getType()) {
             case 1:
-                // Object stored in cache by readObjectAtOffset
-                readObjectAtOffset(true, entry.getOffset(), "", og);
+                {
+                    // Object stored in cache by readObjectAtOffset
+                    auto const warnings = m->warnings.size();
+                    ++cache_stats_.misses;
+                    readObjectAtOffset(true, entry.getOffset(), "", og);
+                    if (max_resident_ && warnings == m->warnings.size()) {
+                        resident_.emplace_back(og);
+                    }
+                }
                 break;
 
             case 2:
-                resolveObjectsInStream(entry.getObjStreamNumber());
+                if (max_object_streams_) {
+                    resolveObjectInStream(og, entry.getObjStreamNumber());
+                } else {
+                    resolveObjectsInStream(entry.getObjStreamNumber());
+                }
                 break;
 
             default:
@@ -1706,8 +1995,8 @@ Objects::resolve(QPDFObjGen og)
     return result;
 }
 
-void
-Objects::resolveObjectsInStream(int obj_stream_number)
+Objects::ObjectStream
+Objects::readObjectStream(int obj_stream_number)
 {
     auto damaged =
         [this, obj_stream_number](int id, qpdf_offset_t offset, std::string const& msg) -> QPDFExc {
@@ -1720,10 +2009,8 @@ Objects::resolveObjectsInStream(int obj_stream_number)
             true};
     };
 
-    if (m->resolved_object_streams.contains(obj_stream_number)) {
-        return;
-    }
-    m->resolved_object_streams.insert(obj_stream_number);
+    ObjectStream result;
+    result.number = obj_stream_number;
     // Force resolution of object stream
     Stream obj_stream = qpdf.getObject(obj_stream_number, 0);
     if (!obj_stream) {
@@ -1735,8 +2022,8 @@ Objects::resolveObjectsInStream(int obj_stream_number)
     // For linearization data in the object, use the data from the object stream for the objects in
     // the stream.
     QPDFObjGen stream_og(obj_stream_number, 0);
-    qpdf_offset_t end_before_space = m->obj_cache[stream_og].end_before_space;
-    qpdf_offset_t end_after_space = m->obj_cache[stream_og].end_after_space;
+    result.end_before_space = m->obj_cache[stream_og].end_before_space;
+    result.end_after_space = m->obj_cache[stream_og].end_after_space;
 
     QPDFObjectHandle dict = obj_stream.getDict();
     if (!dict.isDictionaryOfType("/ObjStm")) {
@@ -1753,16 +2040,13 @@ Objects::resolveObjectsInStream(int obj_stream_number)
             "object stream " + std::to_string(obj_stream_number) + " has incorrect keys");
     }
 
-    // id, offset, size
-    std::vector<std::tuple<int, qpdf_offset_t, size_t>> offsets;
+    result.data = obj_stream.getStreamData(qpdf_dl_specialized);
+    auto& offsets = result.offsets;
 
-    auto stream_data = obj_stream.getStreamData(qpdf_dl_specialized);
+    is::OffsetBuffer input("", result.data);
 
-    is::OffsetBuffer input("", stream_data);
-
-    const auto b_size = stream_data.size();
+    const auto b_size = result.data.size();
     const auto end_offset = static_cast<qpdf_offset_t>(b_size);
-    auto b_start = stream_data.data();
 
     if (first >= end_offset) {
         throw damagedPDF(
@@ -1831,23 +2115,106 @@ Objects::resolveObjectsInStream(int obj_stream_number)
             id, last_offset + first, b_size - static_cast<size_t>(last_offset + first));
     }
 
+    return result;
+}
+
+void
+Objects::resolveObjectsInStream(int obj_stream_number)
+{
+    if (m->resolved_object_streams.contains(obj_stream_number)) {
+        return;
+    }
+    m->resolved_object_streams.insert(obj_stream_number);
+    auto const warnings = m->warnings.size();
+    auto const resident = resident_.size();
+    bool const reread = released_object_streams_.contains(obj_stream_number);
+    ObjIdSet replaced;
+    auto obj_stream = readObjectStream(obj_stream_number);
+    auto b_start = obj_stream.data.data();
+
     // To avoid having to read the object stream multiple times, store all objects that would be
     // found here in the cache.  Remember that some objects stored here might have been overridden
     // by new objects appended to the file, so it is necessary to recheck the xref table and only
-    // cache what would actually be resolved here.
-    for (auto const& [obj_id, obj_offset, obj_size]: offsets) {
+    // cache what would actually be resolved here. If the object stream contains an object more
+    // than once, the last entry wins. If the object stream is being read again after some of its
+    // objects were released, only replace the released objects.
+    for (auto const& [obj_id, obj_offset, obj_size]: obj_stream.offsets) {
         QPDFObjGen og(obj_id, 0);
         auto entry = m->xref_table.find(og);
         if (entry != m->xref_table.end() && entry->second.getType() == 2 &&
             entry->second.getObjStreamNumber() == obj_stream_number) {
+            if (reread && !isUnresolved(og) && !replaced.contains(obj_id)) {
+                continue;
+            }
             is::OffsetBuffer in("", {b_start + obj_offset, obj_size}, obj_offset);
             if (auto oh = Parser::parse(in, obj_stream_number, obj_id, m->tokenizer, qpdf)) {
-                updateCache(og, oh.obj_sp(), end_before_space, end_after_space);
+                updateCache(
+                    og, oh.obj_sp(), obj_stream.end_before_space, obj_stream.end_after_space);
+                if (reread) {
+                    replaced.insert(obj_id);
+                }
+                ++cache_stats_.misses;
+                if (max_resident_) {
+                    resident_.emplace_back(og);
+                }
             }
         } else {
             QTC::TC("qpdf", "QPDF not caching overridden objstm object");
         }
     }
+    if (warnings != m->warnings.size()) {
+        resident_.resize(resident);
+    }
+}
+
+void
+Objects::resolveObjectInStream(QPDFObjGen og, int obj_stream_number)
+{
+    auto const warnings = m->warnings.size();
+    auto const resident = resident_.size();
+    auto it = std::ranges::find(object_streams_, obj_stream_number, &ObjectStream::number);
+    if (it == object_streams_.end()) {
+        ObjectStream obj_stream;
+        obj_stream.number = obj_stream_number;
+        try {
+            obj_stream = readObjectStream(obj_stream_number);
+        } catch (...) {
+            // Remember the damaged object stream as empty so that it is not read again, and the
+            // error not reported again, for each of its objects.
+            object_streams_.emplace_front(std::move(obj_stream));
+            max_object_streams(max_object_streams_);
+            throw;
+        }
+        // Sort by id so that entries can be looked up by binary search. The sort is stable so that
+        // the last entry for each object id, which is the one resolveObjectsInStream would use,
+        // remains last.
+        std::ranges::stable_sort(
+            obj_stream.offsets, {}, [](auto const& e) { return std::get<0>(e); });
+        object_streams_.emplace_front(std::move(obj_stream));
+        max_object_streams(max_object_streams_);
+    } else if (it != object_streams_.begin()) {
+        object_streams_.splice(object_streams_.begin(), object_streams_, it);
+    }
+    auto const& obj_stream = object_streams_.front();
+
+    auto entry = std::ranges::upper_bound(
+        obj_stream.offsets, og.getObj(), {}, [](auto const& e) { return std::get<0>(e); });
+    if (og.getGen() != 0 || entry == obj_stream.offsets.begin() ||
+        std::get<0>(*std::prev(entry)) != og.getObj()) {
+        return;
+    }
+    auto [obj_id, obj_offset, obj_size] = *std::prev(entry);
+    is::OffsetBuffer in("", {obj_stream.data.data() + obj_offset, obj_size}, obj_offset);
+    if (auto oh = Parser::parse(in, obj_stream_number, obj_id, m->tokenizer, qpdf)) {
+        updateCache(og, oh.obj_sp(), obj_stream.end_before_space, obj_stream.end_after_space);
+        ++cache_stats_.misses;
+        if (max_resident_) {
+            resident_.emplace_back(og);
+        }
+    }
+    if (warnings != m->warnings.size()) {
+        resident_.resize(resident);
+    }
 }
 
 QPDFObjectHandle
@@ -1888,6 +2255,193 @@ Objects::isUnresolved(QPDFObjGen og)
     return !isCached(og) || m->obj_cache[og].object->isUnresolved();
 }
 
+bool
+Objects::release(QPDFObjGen og)
+{
+    auto cached = m->obj_cache.find(og);
+    auto entry = m->xref_table.find(og);
+    if (cached == m->obj_cache.end() || entry == m->xref_table.end() ||
+        cached->second.object->isUnresolved()) {
+        // The object has been removed or has already been released.
+        return false;
+    }
+    if (entry->second.getType() == 2) {
+        // Allow the object stream to be read again.
+        m->resolved_object_streams.erase(entry->second.getObjStreamNumber());
+        released_object_streams_.insert(entry->second.getObjStreamNumber());
+    }
+    cached->second.object->assign_unresolved();
+    return true;
+}
+
+bool
+Objects::matches_input(QPDFObjGen og)
+{
+    auto cached = m->obj_cache.find(og);
+    auto entry = m->xref_table.find(og);
+    if (cached == m->obj_cache.end() || entry == m->xref_table.end() ||
+        cached->second.object->isUnresolved()) {
+        return false;
+    }
+    QPDFObjectHandle current = cached->second.object;
+    auto const type = entry->second.getType();
+    auto const offset = type == 1 ? entry->second.getOffset() : 0;
+    auto const obj_stream_number = type == 2 ? entry->second.getObjStreamNumber() : 0;
+
+    // Read the object again without storing it in the cache. Any problems with it have already
+    // been reported when it was first read, so don't report them again, and treat an object that
+    // can't be read again without warnings as changed.
+    auto const warnings = m->warnings.size();
+    bool const suppress = cf.suppress_warnings();
+    cf.suppress_warnings(true);
+    QPDFObjectHandle original;
+    try {
+        if (type == 1) {
+            if (read_object_start(offset) == og) {
+                original = readObject("", og);
+            }
+        } else if (type == 2 && og.getGen() == 0) {
+            auto obj_stream = readObjectStream(obj_stream_number);
+            // As in resolveObjectsInStream, the last entry for an object id wins.
+            auto last = obj_stream.offsets.end();
+            for (auto it = obj_stream.offsets.begin(); it != obj_stream.offsets.end(); ++it) {
+                if (std::get<0>(*it) == og.getObj()) {
+                    last = it;
+                }
+            }
+            if (last != obj_stream.offsets.end()) {
+                auto [obj_id, obj_offset, obj_size] = *last;
+                is::OffsetBuffer in(
+                    "", {obj_stream.data.data() + obj_offset, obj_size}, obj_offset);
+                original = Parser::parse(in, obj_stream_number, obj_id, m->tokenizer, qpdf);
+            }
+        }
+    } catch (std::exception&) {
+        original = {};
+    }
+    cf.suppress_warnings(suppress);
+    if (m->warnings.size() != warnings) {
+        m->warnings.erase(m->warnings.begin() + toI(warnings), m->warnings.end());
+        return false;
+    }
+    if (!original || original.getTypeCode() != current.getTypeCode()) {
+        return false;
+    }
+    if (current.isStream()) {
+        // Changes to stream data mark the stream as modified.
+        return current.getDict().unparse() == original.getDict().unparse();
+    }
+    return current.unparseResolved() == original.unparseResolved();
+}
+
+void
+Objects::max_resident(size_t max)
+{
+    max_resident_ = max;
+    if (max == 0) {
+        resident_.clear();
+    }
+}
+
+void
+Objects::release_excess()
+{
+    // Objects into whose values handles are held are given a second chance at most once per call
+    // so that this terminates if too few objects can be released.
+    auto deferrals = resident_.size();
+    while (resident_.size() > max_resident_) {
+        auto og = resident_.front();
+        resident_.pop_front();
+        auto cached = m->obj_cache.find(og);
+        if (cached == m->obj_cache.end() || cached->second.object->isUnresolved()) {
+            // The object has been removed or replaced by an unresolved object.
+            continue;
+        }
+        if (cached->second.referenced) {
+            cached->second.referenced = false;
+            resident_.emplace_back(og);
+            continue;
+        }
+        switch (cached->second.object->retain()) {
+        case QPDFObject::Retain::no:
+            if (release(og)) {
+                ++cache_stats_.evictions;
+            }
+            break;
+
+        case QPDFObject::Retain::modified:
+            // Modified objects stay in memory for good.
+            break;
+
+        case QPDFObject::Retain::exposed:
+            // The value may have been changed through a reference that was handed out without the
+            // object being marked as modified.
+            if (matches_input(og)) {
+                if (release(og)) {
+                    ++cache_stats_.evictions;
+                }
+            } else {
+                m->obj_cache[og].object->mark_modified();
+            }
+            break;
+
+        case QPDFObject::Retain::shared:
+            resident_.emplace_back(og);
+            if (--deferrals == 0) {
+                return;
+            }
+            break;
+        }
+    }
+}
+
+std::vector<QPDFObjGen>
+Objects::changed_objects()
+{
+    std::vector<QPDFObjGen> result;
+    std::vector<QPDFObjGen> exposed;
+    for (auto const& [og, cache]: m->obj_cache) {
+        auto const& object = cache.object;
+        auto tc = object->getTypeCode();
+        if (tc == ::ot_unresolved || tc == ::ot_reserved) {
+            continue;
+        }
+        if (m->xref_table.contains(og)) {
+            if (object->changed()) {
+                result.emplace_back(og);
+            } else if (object->changed(true)) {
+                exposed.emplace_back(og);
+            }
+        } else if (tc != ::ot_null || object->changed()) {
+            // Unmodified null objects that are not in the xref table are the result of resolving
+            // references to objects that do not exist.
+            result.emplace_back(og);
+        }
+    }
+    // Objects into whose values references have been handed out may have been changed without
+    // being marked as modified. Reading them again may add objects to the cache, so this is done
+    // after the loop above.
+    for (auto og: exposed) {
+        if (!matches_input(og)) {
+            m->obj_cache[og].object->mark_modified();
+            result.emplace_back(og);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+char
+Objects::copy_input(Pipeline& pipeline)
+{
+    m->file->seek(0, SEEK_END);
+    auto size = m->file->tell();
+    if (size <= 0) {
+        throw damagedPDF("", -1, "unable to copy empty input file");
+    }
+    return streams_.copy_raw(0, toS(size), pipeline);
+}
+
 QPDFObjGen
 Objects::nextObjGen()
 {
@@ -1921,16 +2475,22 @@ Objects::getObjectForParser(int id, int gen, bool parse_pdf)
     // This method is called by the parser and therefore must not resolve any objects.
     auto og = QPDFObjGen(id, gen);
     if (auto iter = m->obj_cache.find(og); iter != m->obj_cache.end()) {
-        return iter->second.object;
+        // An object from the file that is read again after being released must not pick up a
+        // dangling reference to an object that has been created since the file was read.
+        if (!(parse_pdf && m->fixed_dangling_refs && id > m->max_file_object_id &&
+              !m->xref_table.contains(og))) {
+            return iter->second.object;
+        }
     }
     if (m->xref_table.contains(og) || (!m->parsed && og.getObj() < m->xref_table_max_id)) {
-        return m->obj_cache.insert({og, QPDFObject::create<QPDF_Unresolved>(&qpdf, og)})
+        return m->obj_cache.try_emplace(og, QPDFObject::create<QPDF_Unresolved>(&qpdf, og))
             .first->second.object;
     }
     if (parse_pdf) {
         return QPDFObject::create<QPDF_Null>();
     }
-    return m->obj_cache.insert({og, QPDFObject::create<QPDF_Null>(&qpdf, og)}).first->second.object;
+    return m->obj_cache.try_emplace(og, QPDFObject::create<QPDF_Null>(&qpdf, og))
+        .first->second.object;
 }
 
 std::shared_ptr<QPDFObject>
@@ -1951,6 +2511,9 @@ QPDFObjectHandle
 QPDF::getObject(QPDFObjGen og)
 {
     if (auto it = m->obj_cache.find(og); it != m->obj_cache.end()) {
+        if (!it->second.object->isUnresolved()) {
+            m->objects.cache_hit(it->second);
+        }
         return {it->second.object};
     } else if (m->parsed && !m->xref_table.contains(og)) {
         return QPDFObject::create<QPDF_Null>();
@@ -1974,6 +2537,7 @@ QPDF::replaceObject(QPDFObjGen og, QPDFObjectHandle oh)
         throw std::logic_error("QPDF::replaceObject called with indirect object handle");
     }
     m->objects.updateCache(og, oh.obj_sp(), -1, -1, false);
+    m->obj_cache[og].object->mark_modified();
 }
 
 void
@@ -1984,7 +2548,7 @@ QPDF::removeObject(QPDFObjGen og)
         // Take care of any object handles that may be floating around.
         cached->second.object->assign_null();
         cached->second.object->setObjGen(nullptr, QPDFObjGen());
-        m->obj_cache.erase(cached);
+        m->obj_cache.erase(og);
     }
 }
 
@@ -2012,6 +2576,60 @@ QPDF::swapObjects(QPDFObjGen og1, QPDFObjGen og2)
     m->objects.resolve(og1);
     m->objects.resolve(og2);
     m->obj_cache[og1].object->swapWith(m->obj_cache[og2].object);
+    m->obj_cache[og1].object->mark_modified();
+    m->obj_cache[og2].object->mark_modified();
+}
+
+void
+QPDF::setObjectCacheLimit(size_t max)
+{
+    m->objects.max_resident(max);
+}
+
+void
+Objects::max_object_streams(size_t max)
+{
+    max_object_streams_ = max;
+    while (object_streams_.size() > max) {
+        object_streams_.pop_back();
+    }
+}
+
+void
+QPDF::setObjectStreamCacheLimit(size_t max)
+{
+    m->objects.max_object_streams(max);
+}
+
+void
+ObjectArena::release(Pool* pool) noexcept
+{
+    if (pool && --pool->refs == 0) {
+        delete pool;
+    }
+}
+
+void
+QPDF::setObjectArena(bool val)
+{
+    auto& arena = m->objects.arena();
+    if (!val) {
+        arena = {};
+    } else if (!arena) {
+        arena = ObjectArena::make();
+    }
+}
+
+void
+QPDF::trimObjectCache()
+{
+    m->objects.release_excess();
+}
+
+QPDF::ObjectCacheStats
+QPDF::getObjectCacheStats() const
+{
+    return m->objects.cache_stats();
 }
 
 size_t
@@ -2019,8 +2637,8 @@ Objects::table_size()
 {
     // If obj_cache is dense, accommodate all object in tables,else accommodate only original
     // objects.
-    auto max_xref = !m->xref_table.empty() ? m->xref_table.crbegin()->first.getObj() : 0;
-    auto max_obj = !m->obj_cache.empty() ? m->obj_cache.crbegin()->first.getObj() : 0;
+    auto max_xref = m->xref_table.max_id();
+    auto max_obj = m->obj_cache.max_id();
     auto max_id = std::numeric_limits<int>::max() - 1;
     if (max_obj >= max_id || max_xref >= max_id) {
         // Temporary fix. Long-term solution is
@@ -2073,6 +2691,7 @@ Objects::compressible()
         result.resize(max_obj + 1U, false);
     }
     while (!queue.empty()) {
+        maybe_release();
         auto obj = queue.back();
         queue.pop_back();
         if (obj.getObjectID() > 0) {
@@ -3,6 +3,7 @@
 #include <qpdf/QUtil.hh>
 #include <cstdio>
 #include <map>
+#include <mutex>
 #include <set>
 
 static bool
@@ -15,6 +16,15 @@ tc_active(char const* const scope)
 void
 QTC::TC_real(char const* const scope, char const* const ccase, int n)
 {
+    // Coverage is only recorded when TC_SCOPE is set, so avoid taking the lock otherwise. QPDFJob
+    // may run QPDF code in several threads at once.
+    static bool const enabled = QUtil::get_env("TC_SCOPE");
+    if (!enabled) {
+        return;
+    }
+    static std::mutex mutex;
+    std::lock_guard lock(mutex);
+
     static std::map<std::string, bool> active;
     auto is_active = active.find(scope);
     if (is_active == active.end()) {
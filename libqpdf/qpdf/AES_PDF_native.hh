@@ -25,6 +25,8 @@ class AES_PDF_native
     unsigned char* cbc_block;
     std::unique_ptr<unsigned char[]> key;
     std::unique_ptr<uint32_t[]> rk;
+    // Round keys for the AES instructions; null if they are not available
+    std::unique_ptr<unsigned char[]> round_keys;
     unsigned int nrounds{0};
 };
 
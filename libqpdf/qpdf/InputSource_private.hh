@@ -65,6 +65,10 @@ namespace qpdf::is
 
         size_t read(char* buffer, size_t length) final;
 
+        // Return a view of up to length bytes starting at offset without copying. The position is
+        // advanced past the returned data as if it had been read.
+        std::string_view view(qpdf_offset_t offset, size_t length);
+
         void
         unreadCh(char ch) final
         {
@@ -147,6 +151,26 @@ InputSource::fastRead(char& ch)
     }
 }
 
+inline std::string_view
+InputSource::fastPeek()
+{
+    // Return the buffered characters that fastRead would return next without consuming them. The
+    // buffer is refilled if it is exhausted. An empty result indicates EOF.
+    if (buf_idx == buf_len && buf_len > 0) {
+        seek(buf_start + buf_len, SEEK_SET);
+        fastTell();
+    }
+    return {buffer + buf_idx, static_cast<size_t>(buf_len - buf_idx)};
+}
+
+inline void
+InputSource::fastSkip(size_t count)
+{
+    // Consume count characters previously returned by fastPeek.
+    buf_idx += static_cast<qpdf_offset_t>(count);
+    last_offset += static_cast<qpdf_offset_t>(count);
+}
+
 inline void
 InputSource::fastUnread(bool back)
 {
@@ -5,7 +5,11 @@
 #include <qpdf/QPDFObjectHandle.hh>
 
 #include "qpdf/QIntC.hh"
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <memory>
+#include <vector>
 
 // A table of objects indexed by object id. This is intended as a more efficient replacement for
 // std::map<QPDFObjGen, T> containers.
@@ -198,4 +202,469 @@ class ObjTable: public std::vector<T>
     }
 };
 
+// A map from object id and generation to T. This is intended as a more efficient replacement for
+// std::map<QPDFObjGen, T> containers whose keys are mostly dense object ids, such as the xref table
+// and the object cache of a QPDF object.
+//
+// Entries are stored in a table indexed by object id. In a valid pdf there is at most one
+// generation per object id, so only one generation per id is held in the table. Further
+// generations, object ids less than 1 and ids that are too large to be accommodated in the table
+// without wasting excessive memory are stored in the map 'others'. Iteration is in ascending order
+// of QPDFObjGen, as for std::map.
+//
+// The table is allocated in fixed-size chunks that are never moved, so that, as for std::map,
+// insertions do not invalidate iterators or references, and erasing an entry only invalidates
+// iterators and references to the erased entry. An iterator holds the key of its entry and
+// advances by seeking the next larger key, so entries inserted during iteration are visited if they
+// come after the current position, whether they are stored in the table or in 'others'.
+template <class T>
+class ObjGenMap
+{
+  public:
+    using key_type = QPDFObjGen;
+    using mapped_type = T;
+    using value_type = std::pair<QPDFObjGen, T>;
+
+  private:
+    using others_t = std::map<QPDFObjGen, value_type>;
+
+  public:
+    template <bool Const>
+    class Iterator
+    {
+        friend class ObjGenMap;
+        template <bool>
+        friend class Iterator;
+        using map_t = std::conditional_t<Const, ObjGenMap const, ObjGenMap>;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ObjGenMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+        using reference = std::conditional_t<Const, value_type const&, value_type&>;
+
+        Iterator() = default;
+
+        template <bool C = Const, class = std::enable_if_t<C>>
+        Iterator(Iterator<false> const& it) :
+            map(it.map),
+            entry(it.entry),
+            key(it.key)
+        {
+        }
+
+        reference
+        operator*() const
+        {
+            return *entry;
+        }
+
+        pointer
+        operator->() const
+        {
+            return entry;
+        }
+
+        Iterator&
+        operator++()
+        {
+            entry = const_cast<ObjGenMap*>(map)->seek(key);
+            if (entry) {
+                key = entry->first;
+            }
+            return *this;
+        }
+
+        Iterator
+        operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool
+        operator==(Iterator const& rhs) const
+        {
+            return entry == rhs.entry;
+        }
+
+      private:
+        Iterator(map_t* map, pointer entry) :
+            map(map),
+            entry(entry)
+        {
+            if (entry) {
+                key = entry->first;
+            }
+        }
+
+        map_t* map{nullptr};
+        pointer entry{nullptr};
+        QPDFObjGen key;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    ObjGenMap() = default;
+    ObjGenMap(ObjGenMap const& other) :
+        others(other.others),
+        table_size(other.table_size),
+        max_id_(other.max_id_)
+    {
+        for (auto const& chunk: other.chunks) {
+            chunks.emplace_back(std::make_unique<value_type[]>(chunk_size));
+            std::copy(chunk.get(), chunk.get() + chunk_size, chunks.back().get());
+        }
+    }
+    ObjGenMap(ObjGenMap&&) = default;
+    ObjGenMap&
+    operator=(ObjGenMap const& other)
+    {
+        if (this != &other) {
+            *this = ObjGenMap(other);
+        }
+        return *this;
+    }
+    ObjGenMap& operator=(ObjGenMap&&) = default;
+
+    iterator
+    begin()
+    {
+        return {this, first(next_slot(1), others.begin())};
+    }
+
+    iterator
+    end()
+    {
+        return {this, nullptr};
+    }
+
+    const_iterator
+    begin() const
+    {
+        return const_cast<ObjGenMap*>(this)->begin();
+    }
+
+    const_iterator
+    end() const
+    {
+        return {this, nullptr};
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    bool
+    empty() const
+    {
+        return size() == 0;
+    }
+
+    size_t
+    size() const
+    {
+        return table_size + others.size();
+    }
+
+    // Return the largest object id present or 0 if the map is empty. This replaces
+    // rbegin()->first.getObj().
+    int
+    max_id() const
+    {
+        return max_id_;
+    }
+
+    bool
+    contains(QPDFObjGen og) const
+    {
+        if (in_table(og)) {
+            return true;
+        }
+        return !others.empty() && others.contains(og);
+    }
+
+    iterator
+    find(QPDFObjGen og)
+    {
+        if (in_table(og)) {
+            return {this, &slot(toS(og.getObj()))};
+        }
+        if (!others.empty()) {
+            if (auto it = others.find(og); it != others.end()) {
+                return {this, &it->second};
+            }
+        }
+        return end();
+    }
+
+    const_iterator
+    find(QPDFObjGen og) const
+    {
+        return const_cast<ObjGenMap*>(this)->find(og);
+    }
+
+    // Return an iterator to the first element with a key greater than og.
+    iterator
+    upper_bound(QPDFObjGen og)
+    {
+        return {this, seek(og)};
+    }
+
+    T&
+    operator[](QPDFObjGen og)
+    {
+        return try_emplace(og).first->second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool>
+    try_emplace(QPDFObjGen og, Args&&... args)
+    {
+        if (auto it = find(og); it != end()) {
+            return {it, false};
+        }
+        auto id = og.getObj();
+        if (id > 0 && toS(id) >= capacity() && toS(id) < 2 * (size() + chunk_size)) {
+            grow(toS(id));
+        }
+        if (id > 0 && toS(id) < capacity() && !slot(toS(id)).first.getObj()) {
+            slot(toS(id)) = value_type(og, T(std::forward<Args>(args)...));
+            ++table_size;
+        } else {
+            others.emplace(og, value_type(og, T(std::forward<Args>(args)...)));
+        }
+        max_id_ = size() == 1 ? id : std::max(max_id_, id);
+        return {find(og), true};
+    }
+
+    size_t
+    erase(QPDFObjGen og)
+    {
+        size_t result = 0;
+        if (in_table(og)) {
+            slot(toS(og.getObj())) = value_type();
+            --table_size;
+            result = 1;
+        } else {
+            result = others.erase(og);
+        }
+        if (result && og.getObj() == max_id_) {
+            update_max_id();
+        }
+        return result;
+    }
+
+    void
+    clear()
+    {
+        chunks.clear();
+        others.clear();
+        table_size = 0;
+        max_id_ = 0;
+    }
+
+  private:
+    static constexpr size_t chunk_bits = 10;
+    static constexpr size_t chunk_size = size_t(1) << chunk_bits;
+
+    static size_t
+    toS(int i)
+    {
+        return static_cast<size_t>(i);
+    }
+
+    static int
+    toI(size_t i)
+    {
+        return static_cast<int>(i);
+    }
+
+    size_t
+    capacity() const
+    {
+        return chunks.size() << chunk_bits;
+    }
+
+    value_type&
+    slot(size_t idx)
+    {
+        return chunks[idx >> chunk_bits][idx & (chunk_size - 1)];
+    }
+
+    value_type const&
+    slot(size_t idx) const
+    {
+        return chunks[idx >> chunk_bits][idx & (chunk_size - 1)];
+    }
+
+    bool
+    in_table(QPDFObjGen og) const
+    {
+        auto id = og.getObj();
+        return id > 0 && toS(id) < capacity() && slot(toS(id)).first == og;
+    }
+
+    // Return the index of the first occupied slot at or after idx, or capacity() if there is none.
+    size_t
+    next_slot(size_t idx) const
+    {
+        auto cap = capacity();
+        while (idx < cap && !slot(idx).first.getObj()) {
+            ++idx;
+        }
+        return std::min(idx, cap);
+    }
+
+    size_t
+    table_upper_bound(QPDFObjGen og) const
+    {
+        auto id = og.getObj();
+        if (id < 1) {
+            return next_slot(1);
+        }
+        if (toS(id) >= capacity()) {
+            return capacity();
+        }
+        return next_slot(og < slot(toS(id)).first ? toS(id) : toS(id) + 1);
+    }
+
+    // Return the entry with the smaller key of the table slot idx, which is capacity() if there is
+    // none, and other, or nullptr if there is neither.
+    value_type*
+    first(size_t idx, typename others_t::iterator other)
+    {
+        value_type* result = idx < capacity() ? &slot(idx) : nullptr;
+        if (other != others.end() && (!result || other->first < result->first)) {
+            result = &other->second;
+        }
+        return result;
+    }
+
+    // Return the first entry with a key greater than og or nullptr if there is none.
+    value_type*
+    seek(QPDFObjGen og)
+    {
+        return first(table_upper_bound(og), others.empty() ? others.end() : others.upper_bound(og));
+    }
+
+    // Recalculate max_id_ after the entry with the largest id has been erased.
+    void
+    update_max_id()
+    {
+        // Another generation of the erased object id may still be present.
+        auto idx = std::min(toS(std::max(max_id_, 0)) + 1, capacity());
+        max_id_ = 0;
+        while (table_size && idx > 1) {
+            if (slot(--idx).first.getObj()) {
+                max_id_ = toI(idx);
+                break;
+            }
+        }
+        if (!others.empty()) {
+            auto other_max = others.rbegin()->first.getObj();
+            max_id_ = table_size ? std::max(max_id_, other_max) : other_max;
+        }
+    }
+
+    // Extend the table to accommodate id. Entries already stored in 'others' are not moved into the
+    // table in order not to invalidate references to them.
+    void
+    grow(size_t id)
+    {
+        while (capacity() <= id) {
+            chunks.emplace_back(std::make_unique<value_type[]>(chunk_size));
+        }
+    }
+
+    std::vector<std::unique_ptr<value_type[]>> chunks;
+    others_t others;
+    size_t table_size{0};
+    int max_id_{0};
+};
+
+// A set of object ids. This is intended as a more efficient replacement for std::set<int>
+// containers of object ids. Ids less than 0 are never members of the set.
+class ObjIdSet
+{
+  public:
+    bool
+    contains(int id) const
+    {
+        return id >= 0 && static_cast<size_t>(id) < bits.size() && bits[static_cast<size_t>(id)];
+    }
+
+    bool
+    insert(int id)
+    {
+        if (id < 0 || contains(id)) {
+            return false;
+        }
+        auto idx = static_cast<size_t>(id);
+        if (idx >= bits.size()) {
+            bits.resize(std::max(idx + 1, 2 * bits.size()), false);
+        }
+        bits[idx] = true;
+        ++count;
+        return true;
+    }
+
+    size_t
+    erase(int id)
+    {
+        if (!contains(id)) {
+            return 0;
+        }
+        bits[static_cast<size_t>(id)] = false;
+        --count;
+        return 1;
+    }
+
+    bool
+    empty() const
+    {
+        return count == 0;
+    }
+
+    size_t
+    size() const
+    {
+        return count;
+    }
+
+    // Return the largest id in the set or -1 if the set is empty.
+    int
+    max() const
+    {
+        for (auto i = bits.size(); count && i > 0; --i) {
+            if (bits[i - 1]) {
+                return static_cast<int>(i - 1);
+            }
+        }
+        return -1;
+    }
+
+    void
+    clear()
+    {
+        bits.clear();
+        count = 0;
+    }
+
+  private:
+    std::vector<bool> bits;
+    size_t count{0};
+};
+
 #endif // OBJTABLE_HH
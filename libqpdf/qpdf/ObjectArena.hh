@@ -0,0 +1,205 @@
+#ifndef OBJECTARENA_HH
+#define OBJECTARENA_HH
+
+#include <qpdf/QPDFObject_private.hh>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace qpdf
+{
+    // A per-document arena from which the parser allocates the objects it creates. Each object is
+    // allocated together with its shared_ptr control block from pools of fixed-size blocks that are
+    // carved out of large chunks, so creating and destroying objects rarely calls into the heap.
+    //
+    // ObjectArena is a reference-counted handle. Every object allocated from the arena holds a
+    // reference, so the arena stays alive until the QPDF object and all objects allocated from it
+    // have been destroyed, at which point all chunks are returned to the heap together. Memory
+    // freed by individual objects is reused by the arena but not returned to the heap before then.
+    //
+    // As for all objects belonging to a QPDF, objects allocated from an arena must not be created
+    // or destroyed by more than one thread at a time. The arena itself is not synchronized.
+    class ObjectArena
+    {
+        // Counts the chunks obtained from the heap.
+        class Upstream final: public std::pmr::memory_resource
+        {
+          public:
+            size_t chunks{0};
+
+          private:
+            void*
+            do_allocate(size_t bytes, size_t alignment) override
+            {
+                ++chunks;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void
+            do_deallocate(void* p, size_t bytes, size_t alignment) override
+            {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool
+            do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        struct Pool
+        {
+            Upstream upstream;
+            std::pmr::unsynchronized_pool_resource resource{&upstream};
+            size_t refs{0};
+            size_t objects{0};
+        };
+
+        static void
+        acquire(Pool* pool) noexcept
+        {
+            if (pool) {
+                ++pool->refs;
+            }
+        }
+
+        static void release(Pool* pool) noexcept;
+
+      public:
+        // Allocator used by std::allocate_shared. The copy held by the control block of each
+        // object keeps the arena alive.
+        template <typename T>
+        class Allocator
+        {
+            template <typename>
+            friend class Allocator;
+
+          public:
+            using value_type = T;
+
+            explicit Allocator(Pool* pool) noexcept :
+                pool(pool)
+            {
+                acquire(pool);
+            }
+
+            Allocator(Allocator const& other) noexcept :
+                Allocator(other.pool)
+            {
+            }
+
+            template <typename U>
+            Allocator(Allocator<U> const& other) noexcept :
+                Allocator(other.pool)
+            {
+            }
+
+            Allocator&
+            operator=(Allocator const& other) noexcept
+            {
+                acquire(other.pool);
+                release(pool);
+                pool = other.pool;
+                return *this;
+            }
+
+            ~Allocator()
+            {
+                release(pool);
+            }
+
+            T*
+            allocate(size_t n)
+            {
+                return static_cast<T*>(pool->resource.allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void
+            deallocate(T* p, size_t n) noexcept
+            {
+                pool->resource.deallocate(p, n * sizeof(T), alignof(T));
+            }
+
+            template <typename U>
+            bool
+            operator==(Allocator<U> const& other) const noexcept
+            {
+                return pool == other.pool;
+            }
+
+          private:
+            Pool* pool;
+        };
+
+        // Create an empty handle. Objects created through an empty handle are allocated from the
+        // heap.
+        ObjectArena() = default;
+
+        ObjectArena(ObjectArena const& other) noexcept :
+            pool(other.pool)
+        {
+            acquire(pool);
+        }
+
+        ObjectArena&
+        operator=(ObjectArena const& other) noexcept
+        {
+            acquire(other.pool);
+            release(pool);
+            pool = other.pool;
+            return *this;
+        }
+
+        ~ObjectArena()
+        {
+            release(pool);
+        }
+
+        static ObjectArena
+        make()
+        {
+            ObjectArena result;
+            result.pool = new Pool;
+            acquire(result.pool);
+            return result;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return pool != nullptr;
+        }
+
+        template <typename T, typename... Args>
+        std::shared_ptr<QPDFObject>
+        create(Args&&... args)
+        {
+            if (!pool) {
+                return QPDFObject::create<T>(std::forward<Args>(args)...);
+            }
+            ++pool->objects;
+            return QPDFObject::allocate<T>(
+                Allocator<QPDFObject>(pool), std::forward<Args>(args)...);
+        }
+
+        // Return the number of objects allocated from the arena.
+        size_t
+        objects() const noexcept
+        {
+            return pool ? pool->objects : 0;
+        }
+
+        // Return the number of chunks the arena has obtained from the heap.
+        size_t
+        chunks() const noexcept
+        {
+            return pool ? pool->upstream.chunks : 0;
+        }
+
+      private:
+        Pool* pool{nullptr};
+    };
+} // namespace qpdf
+
+#endif // OBJECTARENA_HH
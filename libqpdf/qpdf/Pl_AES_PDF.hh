@@ -10,8 +10,14 @@
 class Pl_AES_PDF final: public Pipeline
 {
   public:
-    // key should be a pointer to key_bytes bytes of data
-    Pl_AES_PDF(char const* identifier, Pipeline* next, bool encrypt, std::string key);
+    // key should be a pointer to key_bytes bytes of data. If crypto is given, it is used instead of
+    // a new crypto implementation. It must not be used elsewhere while the pipeline is in use.
+    Pl_AES_PDF(
+        char const* identifier,
+        Pipeline* next,
+        bool encrypt,
+        std::string key,
+        std::shared_ptr<QPDFCryptoImpl> crypto = nullptr);
     ~Pl_AES_PDF() final = default;
 
     void write(unsigned char const* data, size_t len) final;
@@ -35,6 +41,8 @@ class Pl_AES_PDF final: public Pipeline
     void initializeVector();
 
     static unsigned int const buf_size = QPDFCryptoImpl::rijndael_buf_size;
+    // Output is passed to the next pipeline in chunks of up to this many blocks.
+    static unsigned int const out_blocks = 256;
     static bool use_static_iv;
 
     std::string key;
@@ -44,7 +52,8 @@ class Pl_AES_PDF final: public Pipeline
     bool first{true};
     size_t offset{0}; // offset into memory buffer
     unsigned char inbuf[buf_size];
-    unsigned char outbuf[buf_size];
+    unsigned char outbuf[buf_size * out_blocks];
+    size_t out_offset{0}; // offset into output buffer
     unsigned char cbc_block[buf_size];
     unsigned char specified_iv[buf_size];
     bool use_zero_iv{false};
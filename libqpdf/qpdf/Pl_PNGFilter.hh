@@ -4,6 +4,7 @@
 #include <qpdf/Pipeline.hh>
 
 #include <cstdint>
+#include <vector>
 
 // This pipeline applies or reverses the application of a PNG filter as described in the PNG
 // specification.
@@ -40,7 +41,6 @@ class Pl_PNGFilter final: public Pipeline
     void processRow();
     void encodeRow();
     void decodeRow();
-    int PaethPredictor(int a, int b, int c);
 
     action_e action;
     uint32_t bytes_per_row;
@@ -51,6 +51,7 @@ class Pl_PNGFilter final: public Pipeline
     std::shared_ptr<unsigned char> buf2;
     size_t pos{0};
     size_t incoming{0};
+    std::vector<unsigned char> encoded;
 };
 
 #endif // PL_PNGFILTER_HH
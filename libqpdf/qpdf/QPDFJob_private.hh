@@ -4,10 +4,13 @@
 #include <qpdf/QPDFJob.hh>
 
 #include <qpdf/ClosedFileInputSource.hh>
+#include <qpdf/Pl_Flate.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QPDFWriter_private.hh>
 #include <qpdf/QPDF_private.hh>
 
+#include <optional>
+
 // A selection of pages from a single input PDF to be included in the output. This corresponds to a
 // single clause in the --pages option.
 struct QPDFJob::Selection
@@ -39,15 +42,22 @@ struct QPDFJob::Selection
 struct QPDFJob::Input
 {
     void initialize(QPDFJob& job, Inputs& in, QPDF* qpdf = nullptr);
+    QPDFObjectHandle page(QPDFJob& job, size_t idx);
+    bool shares_resources(size_t idx);
 
     std::string password;
     std::unique_ptr<QPDF> qpdf_p;
     QPDF* qpdf;
     ClosedFileInputSource* cfis{};
+    // If pages_from_hints is true, orig_pages is filled in by page() as pages are needed.
     std::vector<QPDFObjectHandle> orig_pages;
     int n_pages;
     std::vector<bool> copied_pages;
     bool remove_unreferenced{false};
+    bool pages_from_hints{false};
+    // With --remove-unreferenced-resources=auto, decide for each page found through the hint tables
+    // whether its resources are shared instead of searching the whole file for shared resources.
+    bool check_hinted_resources{false};
 };
 
 // All PDF input files for a job.
@@ -169,10 +179,12 @@ class QPDFJob::Members
     bool warnings{false};
     unsigned long encryption_status{0};
     bool verbose{false};
+    bool mmap{false};
     std::string password;
     bool decrypt{false};
     bool remove_restrictions{false};
     int split_pages{0};
+    bool incremental_update{false};
     bool progress{false};
     std::function<void(int)> progress_handler{nullptr};
     bool warnings_exit_zero{false};
@@ -201,6 +213,8 @@ class QPDFJob::Members
     bool cleartext_metadata{false};
     bool use_aes{false};
     int compression_level{-1};
+    size_t flate_block_threshold{0};
+    std::optional<Pl_Flate::backend_e> flate_backend;
     int jpeg_quality{-1};
     remove_unref_e remove_unreferenced_page_resources{re_auto};
     bool coalesce_contents{false};
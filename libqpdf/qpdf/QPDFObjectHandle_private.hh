@@ -127,14 +127,13 @@ namespace qpdf
       public:
         // The following methods are not part of the public API.
         std::set<std::string> getKeys();
-        std::map<std::string, QPDFObjectHandle> const& getAsMap() const;
+        std::map<std::string, QPDFObjectHandle> getAsMap() const;
         void replace(std::string const& key, QPDFObjectHandle value);
 
-        using iterator = std::map<std::string, QPDFObjectHandle>::iterator;
-        using const_iterator = std::map<std::string, QPDFObjectHandle>::const_iterator;
-        using reverse_iterator = std::map<std::string, QPDFObjectHandle>::reverse_iterator;
-        using const_reverse_iterator =
-            std::map<std::string, QPDFObjectHandle>::const_reverse_iterator;
+        using iterator = DictionaryItems::iterator;
+        using const_iterator = DictionaryItems::const_iterator;
+        using reverse_iterator = DictionaryItems::reverse_iterator;
+        using const_reverse_iterator = DictionaryItems::const_reverse_iterator;
 
         iterator
         begin()
@@ -611,6 +610,7 @@ namespace qpdf
         setFilterOnWrite(bool val)
         {
             stream()->filter_on_write = val;
+            mark_modified();
         }
         bool
         getFilterOnWrite() const
@@ -661,6 +661,7 @@ namespace qpdf
         addTokenFilter(std::shared_ptr<QPDFObjectHandle::TokenFilter> token_filter)
         {
             stream()->token_filters.emplace_back(token_filter);
+            mark_modified();
         }
         JSON getStreamJSON(
             int json_version,
@@ -681,6 +682,7 @@ namespace qpdf
         {
             auto s = stream();
             s->stream_dict = new_dict;
+            mark_modified();
             setDictDescription();
         }
         bool isRootMetadata() const;
@@ -916,6 +918,36 @@ namespace qpdf
         }
     }
 
+    // Record that the value of the object has been changed so that it is never discarded by a
+    // bounded object cache.
+    inline void
+    BaseHandle::mark_modified() const
+    {
+        auto o = obj.get();
+        while (o && std::holds_alternative<QPDF_Reference>(o->value)) {
+            // see comment in QPDF_Reference.
+            o = std::get<QPDF_Reference>(o->value).obj.get();
+        }
+        if (o) {
+            o->mark_modified();
+        }
+    }
+
+    // Record that a reference through which the value of the object can be changed has been
+    // handed out.
+    inline void
+    BaseHandle::mark_exposed() const
+    {
+        auto o = obj.get();
+        while (o && std::holds_alternative<QPDF_Reference>(o->value)) {
+            // see comment in QPDF_Reference.
+            o = std::get<QPDF_Reference>(o->value).obj.get();
+        }
+        if (o) {
+            o->mark_exposed();
+        }
+    }
+
     inline qpdf_offset_t
     BaseHandle::offset() const
     {
@@ -963,11 +995,6 @@ namespace qpdf
 
 } // namespace qpdf
 
-inline QPDF_Dictionary::QPDF_Dictionary(std::map<std::string, QPDFObjectHandle>&& items) :
-    items(std::move(items))
-{
-}
-
 inline std::shared_ptr<QPDFObject>
 QPDF_Null::create(
     std::shared_ptr<QPDFObject> parent, std::string_view const& static_descr, std::string var_descr)
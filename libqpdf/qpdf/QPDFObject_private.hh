@@ -11,9 +11,12 @@
 #include <qpdf/JSON_writer.hh>
 #include <qpdf/QPDF.hh>
 #include <qpdf/QPDFObjGen.hh>
+#include <qpdf/QPDF_Name.hh>
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -35,6 +38,7 @@ namespace qpdf
 
     namespace impl
     {
+        class Parser;
         class Writer;
     }
 } // namespace qpdf
@@ -101,6 +105,297 @@ class QPDF_Destroyed final
 {
 };
 
+namespace qpdf
+{
+    // The items of a dictionary ordered by key. Most dictionaries only have a few items. They are
+    // kept in a vector sorted by key, which avoids a separate allocation for each item and makes
+    // lookups cache-friendly. Once a dictionary has more than max_flat items, the items are moved
+    // into a std::set to avoid the cost of inserting into the middle of a large vector.
+    //
+    // As for std::map, iteration is in key order. Unlike std::map, inserting or erasing items may
+    // invalidate iterators and references to other items. Keys are interned.
+    class DictionaryItems
+    {
+      public:
+        using key_type = InternedName;
+        using mapped_type = QPDFObjectHandle;
+        using value_type = std::pair<InternedName, QPDFObjectHandle>;
+
+        static constexpr size_t max_flat = 64;
+
+      private:
+        struct Less
+        {
+            using is_transparent = void;
+
+            bool
+            operator()(value_type const& a, value_type const& b) const
+            {
+                return a.first < b.first;
+            }
+
+            bool
+            operator()(value_type const& a, std::string_view b) const
+            {
+                return a.first < b;
+            }
+
+            bool
+            operator()(std::string_view a, value_type const& b) const
+            {
+                return a < b.first;
+            }
+        };
+
+        using tree_t = std::set<value_type, Less>;
+
+      public:
+        template <bool Const>
+        class Iterator
+        {
+            friend class DictionaryItems;
+            template <bool>
+            friend class Iterator;
+
+          public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = DictionaryItems::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+            using reference = std::conditional_t<Const, value_type const&, value_type&>;
+
+            Iterator() = default;
+
+            template <bool C = Const, class = std::enable_if_t<C>>
+            Iterator(Iterator<false> const& it) :
+                flat(it.flat),
+                tree(it.tree),
+                in_tree(it.in_tree)
+            {
+            }
+
+            reference
+            operator*() const
+            {
+                // Items in the tree are only ever modified in ways that do not change their key.
+                return in_tree ? const_cast<value_type&>(*tree) : *flat;
+            }
+
+            pointer
+            operator->() const
+            {
+                return &**this;
+            }
+
+            Iterator&
+            operator++()
+            {
+                if (in_tree) {
+                    ++tree;
+                } else {
+                    ++flat;
+                }
+                return *this;
+            }
+
+            Iterator
+            operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            Iterator&
+            operator--()
+            {
+                if (in_tree) {
+                    --tree;
+                } else {
+                    --flat;
+                }
+                return *this;
+            }
+
+            Iterator
+            operator--(int)
+            {
+                auto result = *this;
+                --*this;
+                return result;
+            }
+
+            bool
+            operator==(Iterator const& rhs) const
+            {
+                return in_tree ? tree == rhs.tree : flat == rhs.flat;
+            }
+
+          private:
+            Iterator(pointer flat) :
+                flat(flat)
+            {
+            }
+
+            Iterator(tree_t::const_iterator tree) :
+                tree(tree),
+                in_tree(true)
+            {
+            }
+
+            pointer flat{nullptr};
+            tree_t::const_iterator tree{};
+            bool in_tree{false};
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        DictionaryItems() = default;
+        DictionaryItems(DictionaryItems const& other) :
+            flat(other.flat),
+            tree(other.tree ? std::make_unique<tree_t>(*other.tree) : nullptr)
+        {
+        }
+        DictionaryItems(DictionaryItems&&) = default;
+        DictionaryItems&
+        operator=(DictionaryItems const& other)
+        {
+            if (this != &other) {
+                *this = DictionaryItems(other);
+            }
+            return *this;
+        }
+        DictionaryItems& operator=(DictionaryItems&&) = default;
+        ~DictionaryItems() = default;
+
+        DictionaryItems(std::map<std::string, QPDFObjectHandle> const& items);
+        DictionaryItems(std::map<std::string, QPDFObjectHandle>&& items);
+
+        std::map<std::string, QPDFObjectHandle> as_map() const;
+
+        size_t
+        size() const
+        {
+            return tree ? tree->size() : flat.size();
+        }
+
+        bool
+        empty() const
+        {
+            return size() == 0;
+        }
+
+        iterator
+        begin()
+        {
+            return tree ? iterator(tree->cbegin()) : iterator(flat.data());
+        }
+
+        iterator
+        end()
+        {
+            return tree ? iterator(tree->cend()) : iterator(flat.data() + flat.size());
+        }
+
+        const_iterator
+        begin() const
+        {
+            return const_cast<DictionaryItems*>(this)->begin();
+        }
+
+        const_iterator
+        end() const
+        {
+            return const_cast<DictionaryItems*>(this)->end();
+        }
+
+        const_iterator
+        cbegin() const
+        {
+            return begin();
+        }
+
+        const_iterator
+        cend() const
+        {
+            return end();
+        }
+
+        reverse_iterator
+        rbegin()
+        {
+            return reverse_iterator(end());
+        }
+
+        reverse_iterator
+        rend()
+        {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator
+        crbegin() const
+        {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator
+        crend() const
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        iterator
+        find(std::string_view key)
+        {
+            if (tree) {
+                return tree->find(key);
+            }
+            auto it = std::lower_bound(flat.begin(), flat.end(), key, Less());
+            return (it != flat.end() && it->first == key) ? iterator(&*it) : end();
+        }
+
+        const_iterator
+        find(std::string_view key) const
+        {
+            return const_cast<DictionaryItems*>(this)->find(key);
+        }
+
+        bool
+        contains(std::string_view key) const
+        {
+            return find(key) != end();
+        }
+
+        // Return a reference to the value for key, inserting a null value if key is not present.
+        QPDFObjectHandle&
+        operator[](std::string_view key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        std::pair<iterator, bool> try_emplace(std::string_view key, QPDFObjectHandle value = {});
+        std::pair<iterator, bool> insert_or_assign(std::string_view key, QPDFObjectHandle value);
+        size_t erase(std::string_view key);
+
+        // Release any excess capacity. This is called once a dictionary is complete.
+        void
+        shrink_to_fit()
+        {
+            flat.shrink_to_fit();
+        }
+
+      private:
+        void make_tree();
+
+        std::vector<value_type> flat;
+        std::unique_ptr<tree_t> tree;
+    };
+} // namespace qpdf
+
 class QPDF_Dictionary final
 {
     friend class QPDFObject;
@@ -111,9 +406,20 @@ class QPDF_Dictionary final
         items(items)
     {
     }
-    inline QPDF_Dictionary(std::map<std::string, QPDFObjectHandle>&& items);
+    QPDF_Dictionary(std::map<std::string, QPDFObjectHandle>&& items) :
+        items(std::move(items))
+    {
+    }
+    QPDF_Dictionary(qpdf::DictionaryItems const& items) :
+        items(items)
+    {
+    }
+    QPDF_Dictionary(qpdf::DictionaryItems&& items) :
+        items(std::move(items))
+    {
+    }
 
-    std::map<std::string, QPDFObjectHandle> items;
+    qpdf::DictionaryItems items;
 };
 
 class QPDF_InlineImage final
@@ -150,11 +456,15 @@ class QPDF_Name final
     friend class qpdf::BaseHandle;
     friend class qpdf::Name;
 
-    explicit QPDF_Name(std::string name) :
-        name(std::move(name))
+    explicit QPDF_Name(std::string_view name) :
+        name(name)
     {
     }
-    std::string name;
+    explicit QPDF_Name(qpdf::InternedName const& name) :
+        name(name)
+    {
+    }
+    qpdf::InternedName name;
 };
 
 class QPDF_Null final
@@ -268,6 +578,7 @@ class QPDF_String final
     friend class QPDFObject;
     friend class qpdf::BaseHandle;
     friend class qpdf::String;
+    friend class qpdf::impl::Parser;
     friend class qpdf::impl::Writer;
 
   public:
@@ -320,6 +631,15 @@ class QPDFObject
             qpdf, og, std::forward<T>(T(std::forward<Args>(args)...)));
     }
 
+    // Create an object, using alloc to allocate the object together with its control block.
+    template <typename T, typename Alloc, typename... Args>
+    static std::shared_ptr<QPDFObject>
+    allocate(Alloc const& alloc, Args&&... args)
+    {
+        return std::allocate_shared<QPDFObject>(
+            alloc, std::forward<T>(T(std::forward<Args>(args)...)));
+    }
+
     // Return a unique type code for the resolved object
     inline qpdf_object_type_e getResolvedTypeCode() const;
 
@@ -338,6 +658,15 @@ class QPDFObject
         object_description = nullptr;
         parsed_offset = -1;
     }
+    // Discard the value of an indirect object read from the input file so that it is read again
+    // when next accessed.
+    void
+    assign_unresolved()
+    {
+        value = QPDF_Unresolved();
+        parsed_offset = -1;
+        exposed = false;
+    }
     void
     move_to(std::shared_ptr<QPDFObject>& o, bool destroy)
     {
@@ -372,6 +701,37 @@ class QPDFObject
         return getTypeCode() == ::ot_unresolved;
     }
 
+    // Record that the value of the object has been changed since it was created or read.
+    void
+    mark_modified()
+    {
+        modified = true;
+    }
+
+    // Record that a reference through which the value of the object can be changed, such as the one
+    // returned by BaseHandle::find, has been handed out. The value may have been changed through
+    // that reference without the object being marked as modified.
+    void
+    mark_exposed()
+    {
+        exposed = true;
+    }
+
+    // Reasons why the value of an indirect object read from the input file must be kept rather
+    // than being discarded and read again when next accessed, or, for exposed, may have to be.
+    enum class Retain { no, modified, shared, exposed };
+
+    // Determine whether the value of this object can be discarded. This is not the case if the
+    // object or any of its direct descendants has been modified, or if any handles to its direct
+    // descendants exist outside of the value. If the object or any of its direct descendants has
+    // been exposed, it can only be discarded if its value is still the same as in the input file.
+    Retain retain() const;
+
+    // Determine whether the value of this object or of any of its direct descendants has been
+    // modified since it was created or read. If include_exposed is true, also return true if the
+    // object or any of its direct descendants has been exposed.
+    bool changed(bool include_exposed = false) const;
+
     struct JSON_Descr
     {
         JSON_Descr(std::shared_ptr<std::string> input, std::string const& object) :
@@ -465,6 +825,7 @@ class QPDFObject
   private:
     friend class QPDF_Stream;
     friend class qpdf::BaseHandle;
+    friend class qpdf::impl::Parser;
     friend class Disconnect;
 
     typedef std::variant<
@@ -494,6 +855,8 @@ class QPDFObject
 
     QPDF* qpdf{nullptr};
     QPDFObjGen og{};
+    bool modified{false};
+    bool exposed{false};
     qpdf_offset_t parsed_offset{-1};
 };
 
@@ -75,7 +75,8 @@ namespace qpdf::impl
         /// @param input The input source to read from.
         /// @param object_description Description of the object for error messages.
         /// @param tokenizer The tokenizer to use for parsing.
-        /// @param decrypter String decrypter for encrypted strings, or nullptr.
+        /// @param decrypter String decrypter for encrypted strings, or nullptr. All strings of the
+        ///        object are decrypted together once the object has been parsed.
         /// @param context The QPDF context.
         /// @param sanity_checks Enable additional sanity checks during parsing.
         /// @return The parsed QPDFObjectHandle.
@@ -83,7 +84,7 @@ namespace qpdf::impl
             InputSource& input,
             std::string const& object_description,
             qpdf::Tokenizer& tokenizer,
-            QPDFObjectHandle::StringDecrypter* decrypter,
+            BatchStringDecrypter* decrypter,
             QPDF& context,
             bool sanity_checks);
 
@@ -147,6 +148,9 @@ namespace qpdf::impl
             obj_id_(obj_id),
             sanity_checks_(sanity_checks)
         {
+            if (context) {
+                arena_ = context->doc().objects().arena();
+            }
         }
 
         /// @brief Parser state enumeration.
@@ -163,7 +167,7 @@ namespace qpdf::impl
             }
 
             std::vector<QPDFObjectHandle> olist;          ///< Object list for arrays/dict values
-            std::map<std::string, QPDFObjectHandle> dict; ///< Dictionary entries
+            qpdf::DictionaryItems dict;                   ///< Dictionary entries
             parser_state_e state;                         ///< Current parser state
             std::string key;                              ///< Current dictionary key
             qpdf_offset_t offset;                         ///< Offset of container start
@@ -189,7 +193,8 @@ namespace qpdf::impl
 
         /// @brief Add an object to the current container.
         /// @param obj The object to add.
-        void add(std::shared_ptr<QPDFObject>&& obj);
+        /// @return The added object.
+        QPDFObjectHandle& add(std::shared_ptr<QPDFObject>&& obj);
 
         /// @brief Add a null object to the current container.
         void add_null();
@@ -206,8 +211,12 @@ namespace qpdf::impl
         /// @tparam T The scalar object type (e.g., QPDF_Integer, QPDF_String).
         /// @tparam Args Constructor argument types.
         /// @param args Arguments to forward to the object constructor.
+        /// @return The added object.
         template <typename T, typename... Args>
-        void add_scalar(Args&&... args);
+        QPDFObjectHandle& add_scalar(Args&&... args);
+
+        /// @brief Decrypt the strings of the object collected in encrypted_strings_.
+        void decrypt_strings();
 
         /// @brief Check if too many bad tokens have been encountered and throw if so.
         void check_too_many_bad_tokens();
@@ -236,6 +245,18 @@ namespace qpdf::impl
         /// @param e The exception to report.
         void warn(QPDFExc const& e) const;
 
+        /// @brief Create an object, allocating it from the context's arena if it has one.
+        /// @tparam T The object type.
+        /// @tparam Args Constructor argument types.
+        /// @param args Arguments to forward to the object constructor.
+        /// @return The new object.
+        template <typename T, typename... Args>
+        std::shared_ptr<QPDFObject>
+        create(Args&&... args)
+        {
+            return arena_.create<T>(std::forward<Args>(args)...);
+        }
+
         /// @brief Create a scalar object with description and parsed offset.
         /// @tparam T The scalar object type.
         /// @tparam Args Constructor argument types.
@@ -255,12 +276,15 @@ namespace qpdf::impl
         std::string const& object_description_;        ///< Description for error messages
         qpdf::Tokenizer& tokenizer_;                   ///< Tokenizer for lexical analysis
         QPDFObjectHandle::StringDecrypter* decrypter_; ///< Decrypter for encrypted strings
+        BatchStringDecrypter* batch_decrypter_{nullptr}; ///< Decrypter for all strings at once
+        std::vector<std::shared_ptr<QPDFObject>> encrypted_strings_; ///< Strings to decrypt
         QPDF* context_;                                ///< QPDF context for object resolution
         std::shared_ptr<QPDFObject::Description> description_; ///< Shared description for objects
         bool parse_pdf_{false};     ///< True if parsing PDF objects vs content streams
         int stream_id_{0};          ///< Object stream ID (for object stream parsing)
         int obj_id_{0};             ///< Object ID within object stream
         bool sanity_checks_{false}; ///< Enable additional validation checks
+        ObjectArena arena_;         ///< Arena for new objects, or empty to use the heap
 
         // Composite object parsing state
         std::vector<StackFrame> stack_; ///< Stack of nested containers
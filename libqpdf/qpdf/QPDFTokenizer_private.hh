@@ -86,6 +86,7 @@ namespace qpdf
         bool isSpace(char);
         bool isDelimiter(char);
         void findEI(InputSource& input);
+        bool scanBulk(InputSource& input, qpdf_offset_t& offset, size_t max_len);
 
         enum state_e {
             st_top,
@@ -57,6 +57,19 @@ namespace qpdf
                 return *this;
             }
 
+            size_t
+            linearize_memory_limit() const
+            {
+                return linearize_memory_limit_;
+            }
+
+            Config&
+            linearize_memory_limit(size_t val)
+            {
+                linearize_memory_limit_ = val;
+                return *this;
+            }
+
             bool
             preserve_encryption() const
             {
@@ -231,6 +244,14 @@ namespace qpdf
 
             Config& qdf(bool val);
 
+            bool
+            incremental() const
+            {
+                return incremental_;
+            }
+
+            Config& incremental(bool val);
+
             bool
             normalize_content() const
             {
@@ -279,6 +300,71 @@ namespace qpdf
 
             Config& pclm(bool val);
 
+            int
+            jobs() const
+            {
+                return jobs_;
+            }
+
+            Config& jobs(int val);
+
+            size_t
+            max_resident_objects() const
+            {
+                return max_resident_objects_;
+            }
+
+            Config&
+            max_resident_objects(size_t val)
+            {
+                max_resident_objects_ = val;
+                return *this;
+            }
+
+            bool
+            defer_compression() const
+            {
+                return defer_compression_;
+            }
+
+            // Choose which streams to filter as if compressing them according to the other
+            // settings, but leave filtered streams uncompressed. Writing the output again with the
+            // same settings produces the same stream data as writing the original would have.
+            Config&
+            defer_compression(bool val)
+            {
+                defer_compression_ = val;
+                return *this;
+            }
+
+            bool
+            dedup_objects() const
+            {
+                return dedup_objects_;
+            }
+
+            Config&
+            dedup_objects(bool val)
+            {
+                dedup_objects_ = val;
+                return *this;
+            }
+
+            std::string const&
+            flate_cache() const
+            {
+                return flate_cache_;
+            }
+
+            // Use the given directory as a persistent cache of compressed stream data. An empty
+            // string disables the cache.
+            Config&
+            flate_cache(std::string const& val)
+            {
+                flate_cache_ = val;
+                return *this;
+            }
+
           private:
             void
             usage(std::string const& msg) const
@@ -292,11 +378,17 @@ namespace qpdf
             std::string extra_header_text_;
             // For linearization only
             std::string linearize_pass1_;
+            std::string flate_cache_;
 
             qpdf_object_stream_e object_streams_{qpdf_o_preserve};
             qpdf_stream_decode_level_e decode_level_{qpdf_dl_generalized};
 
             int forced_extension_level_{0};
+            int jobs_{1};
+            size_t max_resident_objects_{0};
+            size_t linearize_memory_limit_{1 << 28};
+            bool defer_compression_{false};
+            bool dedup_objects_{false};
 
             bool normalize_content_set_{false};
             bool normalize_content_{false};
@@ -314,6 +406,7 @@ namespace qpdf
             bool preserve_encryption_{true};
             bool linearize_{false};
             bool pclm_{false};
+            bool incremental_{false};
             bool encrypt_use_aes_{false};
 
             bool permissive_{true};
@@ -328,6 +421,20 @@ namespace qpdf
 
         Writer(QPDF& qpdf, Config cfg);
 
+        // Return the number of objects that were released from the object cache while writing
+        // with a resident object limit.
+        size_t released_objects() const;
+
+        // Return the number of bytes of stream data that were copied unchanged from the input
+        // file.
+        size_t copied_stream_bytes() const;
+
+        // Return the number of duplicate objects that were not written and the size of their
+        // unparsed dictionaries and raw stream data.
+        std::pair<size_t, size_t> dedup_stats() const;
+
+        // Return the number of hits and misses of the flate cache.
+        std::pair<size_t, size_t> flate_cache_stats() const;
     }; // class Writer
 } // namespace qpdf
 
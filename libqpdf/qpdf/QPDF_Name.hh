@@ -0,0 +1,95 @@
+#ifndef QPDF_NAME_HH
+#define QPDF_NAME_HH
+
+#include <compare>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace qpdf
+{
+    // The value of a name object or dictionary key. Equal names share a single, immutable string
+    // held in a process-wide table, so storing a name costs no allocation and names can be
+    // compared by pointer. The table is thread-safe and only holds names that are in use: an entry
+    // is removed when the last InternedName referring to it is destroyed. Names longer than
+    // max_interned_length are not added to the table and get their own copy instead.
+    class InternedName
+    {
+      public:
+        static constexpr size_t max_interned_length = 64;
+
+        InternedName();
+        explicit InternedName(std::string_view name);
+
+        std::string const&
+        str() const noexcept
+        {
+            return *value;
+        }
+
+        operator std::string const&() const noexcept
+        {
+            return *value;
+        }
+
+        operator std::string_view() const noexcept
+        {
+            return *value;
+        }
+
+        // Return true if the name is held in the name table. The empty name is shared without
+        // using the table.
+        bool
+        interned() const noexcept
+        {
+            return value->size() <= max_interned_length;
+        }
+
+        bool
+        empty() const noexcept
+        {
+            return value->empty();
+        }
+
+        size_t
+        size() const noexcept
+        {
+            return value->size();
+        }
+
+        friend bool
+        operator==(InternedName const& lhs, InternedName const& rhs) noexcept
+        {
+            // Equal names that are short enough to be interned always share their string.
+            return lhs.value == rhs.value || (!lhs.interned() && *lhs.value == *rhs.value);
+        }
+
+        friend bool
+        operator==(InternedName const& lhs, std::string_view rhs) noexcept
+        {
+            return *lhs.value == rhs;
+        }
+
+        friend std::strong_ordering
+        operator<=>(InternedName const& lhs, InternedName const& rhs) noexcept
+        {
+            return lhs.value == rhs.value ? std::strong_ordering::equal
+                                          : *lhs.value <=> *rhs.value;
+        }
+
+        friend std::strong_ordering
+        operator<=>(InternedName const& lhs, std::string_view rhs) noexcept
+        {
+            return std::string_view(*lhs.value) <=> rhs;
+        }
+
+        // Return the number of names currently in the name table.
+        static size_t table_size();
+
+      private:
+        std::shared_ptr<std::string const> value;
+    };
+} // namespace qpdf
+
+#endif // QPDF_NAME_HH
@@ -3,8 +3,11 @@
 
 #include <qpdf/QPDF.hh>
 
+#include <qpdf/ObjTable.hh>
+#include <qpdf/ObjectArena.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFAcroFormDocumentHelper.hh>
+#include <qpdf/QPDFCryptoImpl.hh>
 #include <qpdf/QPDFEmbeddedFileDocumentHelper.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QPDFObject_private.hh>
@@ -15,7 +18,10 @@
 #include <qpdf/global_private.hh>
 
 #include <cinttypes>
+#include <deque>
 #include <exception>
+#include <list>
+#include <optional>
 
 using namespace qpdf;
 
@@ -181,6 +187,9 @@ class QPDF::ObjCache
     std::shared_ptr<QPDFObject> object;
     qpdf_offset_t end_before_space{0};
     qpdf_offset_t end_after_space{0};
+    // Set when the object is requested while in memory. Used by the bounded object cache to give
+    // recently used objects a second chance.
+    bool referenced{false};
 };
 
 class QPDF::EncryptionParameters
@@ -224,11 +233,27 @@ class QPDF::EncryptionParameters
     std::string encryption_key;
     std::string cached_object_encryption_key;
     QPDFObjGen cached_key_og{};
+    bool cached_key_aes{false};
+    std::shared_ptr<QPDFCryptoImpl> string_crypto;
+    std::shared_ptr<QPDFCryptoImpl> stream_crypto;
     bool user_password_matched{false};
     bool owner_password_matched{false};
 };
 
-class QPDF::StringDecrypter final: public QPDFObjectHandle::StringDecrypter
+namespace qpdf::impl
+{
+    // A string decrypter that can decrypt several strings of the same object together. The parser
+    // collects the strings of an object and passes them to decryptStrings once the object has been
+    // read.
+    class BatchStringDecrypter: public QPDFObjectHandle::StringDecrypter
+    {
+      public:
+        ~BatchStringDecrypter() override = default;
+        virtual void decryptStrings(std::vector<std::string*> const& strings) = 0;
+    };
+} // namespace qpdf::impl
+
+class QPDF::StringDecrypter final: public qpdf::impl::BatchStringDecrypter
 {
     friend class QPDF;
 
@@ -240,6 +265,7 @@ class QPDF::StringDecrypter final: public QPDFObjectHandle::StringDecrypter
     {
         qpdf->decryptString(val, og);
     }
+    void decryptStrings(std::vector<std::string*> const& strings) final;
 
   private:
     QPDF* qpdf;
@@ -606,6 +632,12 @@ class QPDF::Doc::Linearization: Common
     bool check();
     void show_data();
 
+    // For QPDF::getLinearizedPageCount and QPDF::getLinearizedPage:
+    size_t page_count();
+    QPDFObjectHandle page(size_t pageno);
+    // Return true if the hint tables place the object among the objects used only by the page.
+    bool page_private(size_t pageno, QPDFObjGen og);
+
     // For QPDFWriter:
 
     template <typename T>
@@ -663,9 +695,9 @@ class QPDF::Doc::Linearization: Common
 
     struct UpdateObjectMapsFrame
     {
-        UpdateObjectMapsFrame(ObjUser const& ou, QPDFObjectHandle oh, bool top);
+        UpdateObjectMapsFrame(size_t ou, QPDFObjectHandle oh, bool top);
 
-        ObjUser const& ou;
+        size_t ou; // index into obj_users_
         QPDFObjectHandle oh;
         bool top;
     };
@@ -799,7 +831,9 @@ class QPDF::Doc::Linearization: Common
 
     // methods to support linearization checking -- implemented in QPDF_linearization.cc
 
-    void readLinearizationData();
+    void readLinearizationData(bool check_npages = true);
+    bool readPageHints();
+    std::optional<size_t> kid_position(QPDFObjectHandle parent, QPDFObjGen kid);
     void checkLinearizationInternal();
     void dumpLinearizationDataInternal();
     void linearizationWarning(std::string_view);
@@ -845,16 +879,34 @@ class QPDF::Doc::Linearization: Common
 
     // Methods to support optimization
 
+    size_t addObjUser(ObjUser const& ou);
     void updateObjectMaps(
         ObjUser const& ou,
         QPDFObjectHandle oh,
         std::function<int(QPDFObjectHandle&)> skip_stream_parameters);
     void filterCompressedObjects(std::map<int, int> const& object_stream_data);
     void filterCompressedObjects(QPDFWriter::ObjTable const& object_stream_data);
-
-    // Optimization data
-    std::map<ObjUser, std::set<QPDFObjGen>> obj_user_to_objects_;
-    std::map<QPDFObjGen, std::set<ObjUser>> object_to_obj_users_;
+    void indexObjectUsers();
+    bool hasObjects(ObjUser const& ou) const;
+    std::vector<QPDFObjGen> const& objectsUsedBy(ObjUser const& ou) const;
+    size_t countObjUsers(QPDFObjGen og) const;
+
+    // Optimization data. Object users are numbered in the order in which they are first seen. For
+    // each object user, obj_user_objects_ holds the objects it uses sorted by object number. The
+    // reverse relation is held in compressed form: used_objects_ holds all objects that have at
+    // least one user, sorted by object number, and the users of used_objects_[i] are the entries
+    // of object_users_ from object_users_start_[i] up to object_users_start_[i + 1].
+    std::map<ObjUser, size_t> obj_user_index_;
+    std::vector<ObjUser> obj_users_;
+    std::vector<std::vector<QPDFObjGen>> obj_user_objects_;
+    std::vector<QPDFObjGen> used_objects_;
+    std::vector<size_t> object_users_start_;
+    std::vector<size_t> object_users_;
+
+    // Scratch space for updateObjectMaps: for each object id, the number of the last traversal in
+    // which the object was visited.
+    std::vector<size_t> visited_in_;
+    size_t traversal_{0};
 
     // Linearization data
     bool linearization_warnings_{false}; // set by linearizationWarning, used by checkLinearization
@@ -867,6 +919,20 @@ class QPDF::Doc::Linearization: Common
     HSharedObject shared_object_hints_;
     HGeneric outline_hints_;
 
+    // Page object ids and page offsets relative to the second page, computed by readPageHints from
+    // the page offset hint table. Empty if the hint tables can't be used to find pages.
+    bool page_hints_read_{false};
+    std::vector<int> hint_page_ids_;
+    std::vector<qpdf_offset_t> hint_page_offsets_;
+    ObjIdSet hint_pages_;
+    // Objects among those of the first page that the shared object hint table shows to be used by
+    // other pages as well. Not valid if the shared object hint table is inconsistent.
+    ObjIdSet first_page_shared_;
+    bool first_page_shared_valid_{false};
+    // For each pages tree node visited by page(), the number of pages before each of its kids.
+    // Empty if the node's /Kids and /Count are inconsistent.
+    std::map<QPDFObjGen, std::map<QPDFObjGen, size_t>> kid_positions_;
+
     // Computed linearization data: used to populate above tables during writing and to compare
     // with them during validation. c_ means computed.
     LinParameters c_linp_;
@@ -971,6 +1037,16 @@ class QPDF::Doc::Objects: Common
                 will_retry);
         }
 
+        // Return true if copy_raw can copy length bytes of stream data starting at offset from the
+        // input file, which requires the input file to be unencrypted and to contain all of the
+        // data.
+        bool can_copy_raw(qpdf_offset_t offset, size_t length);
+
+        // Write length bytes of stream data starting at offset in the input file to pipeline
+        // unchanged without holding all of it in memory at once. Return the last byte written.
+        // can_copy_raw must have returned true for the same range.
+        char copy_raw(qpdf_offset_t offset, size_t length, Pipeline& pipeline);
+
         std::shared_ptr<Copier>&
         copier()
         {
@@ -981,6 +1057,9 @@ class QPDF::Doc::Objects: Common
 
       private:
         std::shared_ptr<Copier> copier_;
+        // Length of the input file as determined by can_copy_raw, and the file it belongs to
+        std::weak_ptr<InputSource> file_end_source_;
+        qpdf_offset_t file_end_{0};
     }; // class QPDF::Doc::Objects::Streams
 
   public:
@@ -1058,13 +1137,98 @@ class QPDF::Doc::Objects: Common
 
     // For QPDFWriter:
 
-    std::map<QPDFObjGen, QPDFXRefEntry> const& xref_table();
+    ObjGenMap<QPDFXRefEntry> const& xref_table();
     std::vector<QPDFObjGen> compressible_vector();
     std::vector<bool> compressible_set();
 
+    // For incremental updates: the offset of the most recent cross-reference section of the input
+    // file, or 0 if there was none that could be read, and whether that section is a
+    // cross-reference stream.
+    qpdf_offset_t
+    last_xref_offset() const
+    {
+        return last_xref_offset_;
+    }
+    bool
+    last_xref_stream() const
+    {
+        return last_xref_stream_;
+    }
+    // Return the objects that have been created or whose values have been changed since the input
+    // file was read, in order of object id.
+    std::vector<QPDFObjGen> changed_objects();
+    // Write the whole input file to pipeline unchanged. Return the last byte written.
+    char copy_input(Pipeline& pipeline);
+
+    // Support for bounding the number of objects kept in memory. While a limit is set, objects read
+    // from the input file without warnings are recorded in the order in which they were read.
+    // release_excess turns recorded objects back into unresolved objects, which are read again
+    // from the input file when next accessed, until no more than the limit remain. Objects are
+    // considered in the order in which they were read, but objects that were requested since they
+    // were last considered, and objects into whose values handles are held, are given a second
+    // chance. Objects that have been modified are never released. The caller must ensure that no
+    // references into the values of recorded objects are held when calling release_excess.
+    // maybe_release calls release_excess only while automatic release has been enabled by a
+    // caller that guarantees this for the whole time, such as QPDFWriter.
+    size_t
+    max_resident() const
+    {
+        return max_resident_;
+    }
+    void max_resident(size_t max);
+    void
+    auto_release(bool val)
+    {
+        auto_release_ = val;
+    }
+    void release_excess();
+    void
+    maybe_release()
+    {
+        if (auto_release_) {
+            release_excess();
+        }
+    }
+    QPDF::ObjectCacheStats const&
+    cache_stats() const
+    {
+        return cache_stats_;
+    }
+    // Record a request for an object that is in memory.
+    void
+    cache_hit(ObjCache& cache)
+    {
+        cache.referenced = true;
+        ++cache_stats_.hits;
+    }
+
+    // Support for parsing the members of object streams on demand. While a limit is set, resolving
+    // an object in an object stream parses only that object. The decoded data and offset tables of
+    // up to max_object_streams object streams are kept, most recently used first.
+    void max_object_streams(size_t max);
+
+    // The arena from which the parser allocates objects. This is an empty handle unless arena
+    // allocation has been enabled with QPDF::setObjectArena.
+    ObjectArena&
+    arena()
+    {
+        return arena_;
+    }
+
   private:
     class PatternFinder;
 
+    // The decoded data of an object stream. offsets holds the id, offset and size of each object in
+    // the stream.
+    struct ObjectStream
+    {
+        int number{0};
+        std::string data;
+        std::vector<std::tuple<int, qpdf_offset_t, size_t>> offsets;
+        qpdf_offset_t end_before_space{0};
+        qpdf_offset_t end_after_space{0};
+    };
+
     // Get a list of objects that would be permitted in an object stream.
     template <typename T>
     std::vector<T> compressible();
@@ -1102,9 +1266,14 @@ class QPDF::Doc::Objects: Common
         qpdf_offset_t offset,
         std::string const& description,
         QPDFObjGen exp_og);
+    ObjectStream readObjectStream(int obj_stream_number);
     void resolveObjectsInStream(int obj_stream_number);
+    void resolveObjectInStream(QPDFObjGen og, int obj_stream_number);
     bool isCached(QPDFObjGen og);
     bool isUnresolved(QPDFObjGen og);
+    bool release(QPDFObjGen og);
+    // Return true if the value of og in memory is the same as when it is read from the input file.
+    bool matches_input(QPDFObjGen og);
     void setLastObjectDescription(std::string const& description, QPDFObjGen og);
 
     // Methods to support pattern finding
@@ -1119,6 +1288,23 @@ class QPDF::Doc::Objects: Common
     qpdf_offset_t first_xref_item_offset_{0}; // actual value from file
     bool uncompressed_after_compressed_{false};
     bool root_checked_{false};
+
+    // Incremental update data
+    qpdf_offset_t last_xref_offset_{0};
+    bool last_xref_stream_{false};
+
+    // Bounded object cache data
+    size_t max_resident_{0};
+    bool auto_release_{false};
+    std::deque<QPDFObjGen> resident_;
+    ObjIdSet released_object_streams_;
+    QPDF::ObjectCacheStats cache_stats_;
+
+    // Decoded object stream cache data
+    size_t max_object_streams_{0};
+    std::list<ObjectStream> object_streams_;
+
+    ObjectArena arena_;
 }; // class QPDF::Doc::Objects
 
 // This class is used to represent a PDF Pages tree.
@@ -1192,6 +1378,24 @@ class QPDF::Doc::Pages: Common
         return ever_called_get_all_pages_;
     }
 
+    // Set once a page has been found through the linearization hint tables. From then on, checking
+    // whether an object is a page or pages tree node doesn't read the whole pages tree first.
+    void
+    used_hints()
+    {
+        used_hints_ = true;
+    }
+
+    // Read the pages tree, which repairs missing /Type keys, unless pages are being found through
+    // the linearization hint tables.
+    void
+    repair_types()
+    {
+        if (!used_hints_) {
+            (void)all();
+        }
+    }
+
     void pushInheritedAttributesToPage(bool allow_changes, bool warn_skipped_keys);
 
   private:
@@ -1224,6 +1428,7 @@ class QPDF::Doc::Pages: Common
     bool invalid_page_found{false};
     bool ever_pushed_inherited_attributes_to_pages_{false};
     bool ever_called_get_all_pages_{false};
+    bool used_hints_{false};
 
 }; // class QPDF::Doc::Pages
 
@@ -1249,21 +1454,24 @@ class QPDF::Members: Doc
     std::shared_ptr<QPDFObject::Description> last_ostream_description;
     std::shared_ptr<EncryptionParameters> encp;
     std::string pdf_version;
-    std::map<QPDFObjGen, QPDFXRefEntry> xref_table;
+    ObjGenMap<QPDFXRefEntry> xref_table;
     // Various tables are indexed by object id, with potential size id + 1
     int xref_table_max_id{std::numeric_limits<int>::max() - 1};
     qpdf_offset_t xref_table_max_offset{0};
-    std::set<int> deleted_objects;
-    std::map<QPDFObjGen, ObjCache> obj_cache;
+    ObjIdSet deleted_objects;
+    ObjGenMap<ObjCache> obj_cache;
     std::set<QPDFObjGen> resolving;
     QPDFObjectHandle trailer;
     std::vector<QPDFExc> warnings;
     bool reconstructed_xref{false};
     bool in_read_xref_stream{false};
     bool fixed_dangling_refs{false};
+    // Highest object ID in use when dangling references were fixed. Any object with a higher ID
+    // was created after all objects in the file had been read.
+    int max_file_object_id{0};
     bool in_parse{false};
     bool parsed{false};
-    std::set<int> resolved_object_streams;
+    ObjIdSet resolved_object_streams;
 };
 
 // The Resolver class is restricted to QPDFObject and BaseHandle so that only it can resolve
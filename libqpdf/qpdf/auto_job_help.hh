@@ -125,6 +125,16 @@ ap.addOptionHelp("--keep-files-open-threshold", "general", "set threshold for --
 Set the threshold used by --keep-files-open, overriding the
 default value of 200.
 )");
+ap.addOptionHelp("--mmap", "general", "read input files through memory mapping", R"(Map input files into memory instead of reading them with
+ordinary file I/O. This can be faster for large files.
+)");
+ap.addOptionHelp("--max-resident-objects", "general", "limit objects kept in memory while writing", R"(--max-resident-objects=count
+
+Write the output in low-memory mode: once more than count
+objects read from the input file while writing are in memory,
+release the oldest ones, reading them again from the input
+file if they are needed later.
+)");
 ap.addHelpTopic("advanced-control", "tweak qpdf's behavior", R"(Advanced control options control qpdf's behavior in ways that would
 normally never be needed by a user but that may be useful to
 developers or people investigating problems with specific files.
@@ -153,10 +163,18 @@ the structure without changing the content.
 )");
 ap.addOptionHelp("--linearize", "transformation", "linearize (web-optimize) output", R"(Create linearized (web-optimized) output files.
 )");
+ap.addOptionHelp("--incremental-update", "transformation", "append changes to a copy of the input file", R"(Write the input file unchanged followed by only the objects
+that were created or modified and a new cross-reference
+section. Can't be combined with encryption, --linearize, or
+--qdf.
+)");
 ap.addOptionHelp("--encrypt", "transformation", "start encryption options", R"(--encrypt [options] --
 
 Run qpdf --help=encryption for details.
 )");
+}
+static void add_help_3(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--decrypt", "transformation", "remove encryption from input file", R"(Create an unencrypted output file even if the input file was
 encrypted. Normally qpdf preserves whatever encryption was
 present on the input file. This option overrides that behavior.
@@ -173,9 +191,6 @@ Copy encryption details from the specified file instead of
 preserving the input file's encryption. Use --encryption-file-password
 to specify the encryption file's password.
 )");
-}
-static void add_help_3(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--encryption-file-password", "transformation", "supply password for --copy-encryption", R"(--encryption-file-password=password
 
 If the file named in --copy-encryption requires a password, use
@@ -239,6 +254,32 @@ gzip), which is the default compression for most PDF files.
 You need --recompress-flate with this option if you want to
 change already compressed streams.
 )");
+ap.addOptionHelp("--jobs", "transformation", "use n threads when writing", R"(--jobs=n
+
+Use up to n threads when writing output files. Stream data is
+compressed by worker threads ahead of the writer. The output is
+identical to the output written with a single thread.
+)");
+ap.addOptionHelp("--flate-block-threshold", "transformation", "compress large streams in parallel blocks", R"(--flate-block-threshold=bytes
+
+Compress streams whose uncompressed size is at least the given
+number of bytes as a sequence of independent 1 MiB blocks. With
+--jobs, the blocks of a single stream are compressed in
+parallel.
+)");
+ap.addOptionHelp("--flate-backend", "transformation", "select the flate compression library", R"(--flate-backend=backend
+
+Select the library used for flate compression and
+decompression: zlib (the default) or libdeflate. libdeflate is
+only available if qpdf was built with libdeflate support.
+)");
+ap.addOptionHelp("--flate-cache", "transformation", "cache compressed stream data across runs", R"(--flate-cache=directory
+
+Look up stream data that is compressed while writing the output
+in the given directory, and store it there if it is not found,
+so that streams that occur in many files are only compressed
+once. The directory must exist.
+)");
 ap.addOptionHelp("--jpeg-quality", "transformation", "set jpeg quality level for jpeg", R"(--jpeg-quality=level
 
 When rewriting images with --optimize-images, set a quality
@@ -263,6 +304,13 @@ Control what qpdf does regarding object streams. Options:
 )");
 ap.addOptionHelp("--preserve-unreferenced", "transformation", "preserve unreferenced objects", R"(Preserve all objects from the input even if not referenced.
 )");
+}
+static void add_help_4(QPDFArgParser& ap)
+{
+ap.addOptionHelp("--dedup-objects", "transformation", "write identical objects only once", R"(Write streams and other objects that are identical to each
+other only once. This can make files assembled from several
+input files much smaller.
+)");
 ap.addOptionHelp("--remove-unreferenced-resources", "transformation", "remove unreferenced page resources", R"(--remove-unreferenced-resources=parameter
 
 Remove from a page's resource dictionary any resources that are
@@ -292,9 +340,6 @@ version. The version number format is
 to "major.minor" and the extension level, if specified, to
 "extension-level".
 )");
-}
-static void add_help_4(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--force-version", "transformation", "set output PDF version", R"(--force-version=version
 
 Force the output PDF file's PDF version header to be the specified
@@ -384,6 +429,9 @@ identical rotation semantics by modifying the page's contents.
 This can be useful if a broken PDF viewer fails to properly
 consider page rotation metadata.
 )");
+}
+static void add_help_5(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--flatten-annotations", "modification", "push annotations into content", R"(--flatten-annotations=parameter
 
 Push page annotations into the content streams. This may be
@@ -427,9 +475,6 @@ Don't optimize images whose area in pixels is below the specified value.
 )");
 ap.addOptionHelp("--keep-inline-images", "modification", "exclude inline images from optimization", R"(Prevent inline images from being considered by --optimize-images.
 )");
-}
-static void add_help_5(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--remove-acroform", "modification", "remove the interactive form dictionary", R"(Exclude the interactive form dictionary from the output file. This
 option only removes the interactive form dictionary from the
 document catalog. It does not remove form field dictionaries or
@@ -586,6 +631,9 @@ The current PDF specification does not allow restriction of
 document accessibility. This option is not available with 40-bit
 encryption.
 )");
+}
+static void add_help_6(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--annotate", "encryption", "restrict document annotation", R"(--annotate=[y|n]
 
 Enable/disable modifying annotations including making comments
@@ -647,9 +695,6 @@ ap.addOptionHelp("--cleartext-metadata", "encryption", "don't encrypt metadata",
 encrypting the rest of the document. This option is not
 available with 40-bit encryption.
 )");
-}
-static void add_help_6(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--use-aes", "encryption", "use AES with 128-bit encryption", R"(--use-aes=[y|n]
 
 Enables/disables use of the more secure AES encryption with
@@ -782,6 +827,9 @@ ap.addOptionHelp("--add-attachment", "attachments", "start add attachment option
 The --add-attachment flag and its options may be repeated to add
 multiple attachments. Run qpdf --help=add-attachment for details.
 )");
+}
+static void add_help_7(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--copy-attachments-from", "attachments", "start copy attachment options", R"(--copy-attachments-from file [options] --
 
 The --copy-attachments-from flag and its options may be repeated
@@ -833,9 +881,6 @@ Specify the attachment's modification date in PDF format;
 defaults to the current time. Run qpdf --help=pdf-dates for
 information about the date format.
 )");
-}
-static void add_help_7(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--mimetype", "add-attachment", "attachment mime type, e.g. application/pdf", R"(--mimetype=type/subtype
 
 Specify the mime type for the attachment, such as text/plain,
@@ -897,6 +942,9 @@ password recovery.
 ap.addOptionHelp("--show-encryption-key", "inspection", "show key with --show-encryption", R"(When used with --show-encryption or --check, causes the
 underlying encryption key to be displayed.
 )");
+}
+static void add_help_8(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--check-linearization", "inspection", "check linearization tables", R"(Check to see whether a file is linearized and, if so, whether
 the linearization hint tables are correct.
 )");
@@ -929,9 +977,6 @@ Useful for scripts.
 ap.addOptionHelp("--show-pages", "inspection", "display page dictionary information", R"(Show the object and generation number for each page dictionary
 object and for each content stream associated with the page.
 )");
-}
-static void add_help_8(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--with-images", "inspection", "include image details with --show-pages", R"(When used with --show-pages, also shows the object and
 generation numbers for the image objects on each page.
 )");
@@ -999,6 +1044,9 @@ representation of the original PDF and contains no additional
 JSON keys. See also --json-stream-data, --json-stream-prefix,
 and --decode-level.
 )");
+}
+static void add_help_9(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--json-input", "json", "input file is qpdf JSON", R"(Treat the input file as a JSON file in qpdf JSON format. See the
 "qpdf JSON Format" section of the manual for information about
 how to use this option.
@@ -1038,9 +1086,6 @@ parsing. The limit applies when the PDF document's xref table is undamaged
 and the object itself can be parsed without errors. The default limit
 is 4,294,967,295. See also --parser-max-container-size-damaged.
 )");
-}
-static void add_help_9(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--parser-max-container-size-damaged", "global", "set the maximum container size while parsing damaged files", R"(--parser-max-container-size-damaged=n
 
 Set the maximum number of top-level objects allowed in a container while
@@ -17,6 +17,7 @@ static char const* password_mode_choices[] = {"bytes", "hex-bytes", "unicode", "
 static char const* stream_data_choices[] = {"compress", "preserve", "uncompress", 0};
 static char const* decode_level_choices[] = {"none", "generalized", "specialized", "all", 0};
 static char const* object_streams_choices[] = {"disable", "preserve", "generate", 0};
+static char const* flate_backend_choices[] = {"zlib", "libdeflate", 0};
 static char const* remove_unref_choices[] = {"auto", "yes", "no", 0};
 static char const* flatten_choices[] = {"all", "print", "screen", 0};
 static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", 0};
@@ -50,6 +51,7 @@ this->ap.addBare("check-linearization", [this](){c_main->checkLinearization();})
 this->ap.addBare("coalesce-contents", [this](){c_main->coalesceContents();});
 this->ap.addBare("copy-attachments-from", b(&ArgParser::argCopyAttachmentsFrom));
 this->ap.addBare("decrypt", [this](){c_main->decrypt();});
+this->ap.addBare("dedup-objects", [this](){c_main->dedupObjects();});
 this->ap.addBare("deterministic-id", [this](){c_main->deterministicId();});
 this->ap.addBare("empty", b(&ArgParser::argEmpty));
 this->ap.addBare("encrypt", b(&ArgParser::argEncrypt));
@@ -59,11 +61,13 @@ this->ap.addBare("flatten-rotation", [this](){c_main->flattenRotation();});
 this->ap.addBare("generate-appearances", [this](){c_main->generateAppearances();});
 this->ap.addBare("global", b(&ArgParser::argGlobal));
 this->ap.addBare("ignore-xref-streams", [this](){c_main->ignoreXrefStreams();});
+this->ap.addBare("incremental-update", [this](){c_main->incrementalUpdate();});
 this->ap.addBare("is-encrypted", [this](){c_main->isEncrypted();});
 this->ap.addBare("json-input", [this](){c_main->jsonInput();});
 this->ap.addBare("keep-inline-images", [this](){c_main->keepInlineImages();});
 this->ap.addBare("linearize", [this](){c_main->linearize();});
 this->ap.addBare("list-attachments", [this](){c_main->listAttachments();});
+this->ap.addBare("mmap", [this](){c_main->mmap();});
 this->ap.addBare("newline-before-endstream", [this](){c_main->newlineBeforeEndstream();});
 this->ap.addBare("no-original-object-ids", [this](){c_main->noOriginalObjectIds();});
 this->ap.addBare("no-warn", [this](){c_main->noWarn();});
@@ -104,11 +108,14 @@ this->ap.addBare("warning-exit-0", [this](){c_main->warningExit0();});
 this->ap.addBare("with-images", [this](){c_main->withImages();});
 this->ap.addRequiredParameter("compression-level", [this](std::string const& x){c_main->compressionLevel(x);}, "level");
 this->ap.addRequiredParameter("jpeg-quality", [this](std::string const& x){c_main->jpegQuality(x);}, "level");
+this->ap.addRequiredParameter("jobs", [this](std::string const& x){c_main->jobs(x);}, "n");
+this->ap.addRequiredParameter("flate-block-threshold", [this](std::string const& x){c_main->flateBlockThreshold(x);}, "bytes");
 this->ap.addRequiredParameter("encryption-file-password", [this](std::string const& x){c_main->encryptionFilePassword(x);}, "password");
 this->ap.addRequiredParameter("force-version", [this](std::string const& x){c_main->forceVersion(x);}, "version");
 this->ap.addRequiredParameter("ii-min-bytes", [this](std::string const& x){c_main->iiMinBytes(x);}, "minimum");
 this->ap.addRequiredParameter("json-object", [this](std::string const& x){c_main->jsonObject(x);}, "trailer");
 this->ap.addRequiredParameter("keep-files-open-threshold", [this](std::string const& x){c_main->keepFilesOpenThreshold(x);}, "count");
+this->ap.addRequiredParameter("max-resident-objects", [this](std::string const& x){c_main->maxResidentObjects(x);}, "count");
 this->ap.addRequiredParameter("min-version", [this](std::string const& x){c_main->minVersion(x);}, "version");
 this->ap.addRequiredParameter("oi-min-area", [this](std::string const& x){c_main->oiMinArea(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-height", [this](std::string const& x){c_main->oiMinHeight(x);}, "minimum");
@@ -124,11 +131,13 @@ this->ap.addRequiredParameter("linearize-pass1", [this](std::string const& x){c_
 this->ap.addRequiredParameter("password-file", [this](std::string const& x){c_main->passwordFile(x);}, "password");
 this->ap.addRequiredParameter("update-from-json", [this](std::string const& x){c_main->updateFromJson(x);}, "qpdf-json file");
 this->ap.addRequiredParameter("json-stream-prefix", [this](std::string const& x){c_main->jsonStreamPrefix(x);}, "stream-file-prefix");
+this->ap.addRequiredParameter("flate-cache", [this](std::string const& x){c_main->flateCache(x);}, "directory");
 this->ap.addOptionalParameter("collate", [this](std::string const& x){c_main->collate(x);});
 this->ap.addOptionalParameter("split-pages", [this](std::string const& x){c_main->splitPages(x);});
 this->ap.addChoices("compress-streams", [this](std::string const& x){c_main->compressStreams(x);}, true, yn_choices);
 this->ap.addChoices("decode-level", [this](std::string const& x){c_main->decodeLevel(x);}, true, decode_level_choices);
 this->ap.addChoices("flatten-annotations", [this](std::string const& x){c_main->flattenAnnotations(x);}, true, flatten_choices);
+this->ap.addChoices("flate-backend", [this](std::string const& x){c_main->flateBackend(x);}, true, flate_backend_choices);
 this->ap.addChoices("json-key", [this](std::string const& x){c_main->jsonKey(x);}, true, json_key_choices);
 this->ap.addChoices("json-stream-data", [this](std::string const& x){c_main->jsonStreamData(x);}, true, json_stream_data_choices);
 this->ap.addChoices("keep-files-open", [this](std::string const& x){c_main->keepFilesOpen(x);}, true, yn_choices);
@@ -10,6 +10,7 @@ static char const* password_mode_choices[] = {"bytes", "hex-bytes", "unicode", "
 static char const* stream_data_choices[] = {"compress", "preserve", "uncompress", 0};
 static char const* decode_level_choices[] = {"none", "generalized", "specialized", "all", 0};
 static char const* object_streams_choices[] = {"disable", "preserve", "generate", 0};
+static char const* flate_backend_choices[] = {"zlib", "libdeflate", 0};
 static char const* remove_unref_choices[] = {"auto", "yes", "no", 0};
 static char const* flatten_choices[] = {"all", "print", "screen", 0};
 static char const* json_key_choices[] = {"acroform", "attachments", "encrypt", "objectinfo", "objects", "outlines", "pagelabels", "pages", "qpdf", 0};
@@ -68,6 +69,9 @@ popHandler(); // key: decodeLevel
 pushKey("decrypt");
 addBare([this]() { c_main->decrypt(); });
 popHandler(); // key: decrypt
+pushKey("dedupObjects");
+addBare([this]() { c_main->dedupObjects(); });
+popHandler(); // key: dedupObjects
 pushKey("deterministicId");
 addBare([this]() { c_main->deterministicId(); });
 popHandler(); // key: deterministicId
@@ -86,6 +90,9 @@ popHandler(); // key: copyEncryption
 pushKey("encryptionFilePassword");
 addParameter([this](std::string const& p) { c_main->encryptionFilePassword(p); });
 popHandler(); // key: encryptionFilePassword
+pushKey("incrementalUpdate");
+addBare([this]() { c_main->incrementalUpdate(); });
+popHandler(); // key: incrementalUpdate
 pushKey("linearize");
 addBare([this]() { c_main->linearize(); });
 popHandler(); // key: linearize
@@ -305,6 +312,12 @@ popHandler(); // key: keepFilesOpen
 pushKey("keepFilesOpenThreshold");
 addParameter([this](std::string const& p) { c_main->keepFilesOpenThreshold(p); });
 popHandler(); // key: keepFilesOpenThreshold
+pushKey("mmap");
+addBare([this]() { c_main->mmap(); });
+popHandler(); // key: mmap
+pushKey("maxResidentObjects");
+addParameter([this](std::string const& p) { c_main->maxResidentObjects(p); });
+popHandler(); // key: maxResidentObjects
 pushKey("noWarn");
 addBare([this]() { c_main->noWarn(); });
 popHandler(); // key: noWarn
@@ -335,6 +348,18 @@ popHandler(); // key: coalesceContents
 pushKey("compressionLevel");
 addParameter([this](std::string const& p) { c_main->compressionLevel(p); });
 popHandler(); // key: compressionLevel
+pushKey("jobs");
+addParameter([this](std::string const& p) { c_main->jobs(p); });
+popHandler(); // key: jobs
+pushKey("flateBlockThreshold");
+addParameter([this](std::string const& p) { c_main->flateBlockThreshold(p); });
+popHandler(); // key: flateBlockThreshold
+pushKey("flateBackend");
+addChoices(flate_backend_choices, true, [this](std::string const& p) { c_main->flateBackend(p); });
+popHandler(); // key: flateBackend
+pushKey("flateCache");
+addParameter([this](std::string const& p) { c_main->flateCache(p); });
+popHandler(); // key: flateCache
 pushKey("jpegQuality");
 addParameter([this](std::string const& p) { c_main->jpegQuality(p); });
 popHandler(); // key: jpegQuality
@@ -15,12 +15,14 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "recompressFlate": "uncompress and recompress flate",
   "decodeLevel": "control which streams to uncompress",
   "decrypt": "remove encryption from input file",
+  "dedupObjects": "write identical objects only once",
   "deterministicId": "generate ID deterministically",
   "staticAesIv": "use a fixed AES vector",
   "staticId": "use a fixed document ID",
   "noOriginalObjectIds": "omit original object IDs in qdf",
   "copyEncryption": "copy another file's encryption details",
   "encryptionFilePassword": "supply password for copyEncryption",
+  "incrementalUpdate": "append changes to a copy of the input file",
   "linearize": "linearize (web-optimize) output",
   "linearizePass1": "save pass 1 of linearization",
   "objectStreams": "control use of object streams",
@@ -102,6 +104,8 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "allowWeakCrypto": "allow insecure cryptographic algorithms",
   "keepFilesOpen": "manage keeping multiple files open",
   "keepFilesOpenThreshold": "set threshold for keepFilesOpen",
+  "mmap": "read input files through memory mapping",
+  "maxResidentObjects": "limit objects kept in memory while writing",
   "noWarn": "suppress printing of warning messages",
   "verbose": "print additional information",
   "testJsonSchema": "test generated json against schema",
@@ -112,6 +116,10 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "suppressRecovery": "suppress error recovery",
   "coalesceContents": "combine content streams",
   "compressionLevel": "set compression level for flate",
+  "jobs": "use n threads when writing",
+  "flateBlockThreshold": "compress large streams in parallel blocks",
+  "flateBackend": "select the flate compression library",
+  "flateCache": "cache compressed stream data across runs",
   "jpegQuality": "set jpeg quality level for jpeg",
   "externalizeInlineImages": "convert inline to regular images",
   "iiMinBytes": "set minimum size for externalizeInlineImages",
@@ -1,8 +1,13 @@
+#include <qpdf/assert_test.h>
+
 #include <qpdf/Pl_AES_PDF.hh>
 #include <qpdf/Pl_StdioFile.hh>
+#include <qpdf/Pl_String.hh>
 #include <qpdf/QIntC.hh>
+#include <qpdf/QPDFCryptoProvider.hh>
 #include <qpdf/QUtil.hh>
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -19,10 +24,58 @@ usage()
               << "  -zero-iv     -- use zero initialization vector" << '\n'
               << "  -static-iv   -- use static initialization vector" << '\n'
               << "  -no-padding  -- disable padding" << '\n'
-              << "Options must precede key and file names." << '\n';
+              << "Options must precede key and file names." << '\n'
+              << "Usage: aes -benchmark megabytes" << '\n';
     exit(2);
 }
 
+static double
+run_aes(bool encrypt, std::string const& key, std::string const& in, std::string& out)
+{
+    out.clear();
+    Pl_String sink("sink", nullptr, out);
+    Pl_AES_PDF aes("aes", &sink, encrypt, key);
+    aes.useStaticIV();
+    auto start = std::chrono::steady_clock::now();
+    aes.write(reinterpret_cast<unsigned char const*>(in.data()), in.size());
+    aes.finish();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Encrypt and decrypt with every registered crypto provider, check that they all agree, and report
+// their throughput.
+static void
+benchmark(size_t megabytes)
+{
+    std::string clear(megabytes << 20, '\0');
+    for (size_t i = 0; i < clear.size(); ++i) {
+        clear[i] = static_cast<char>((i * 7 + (i >> 11)) & 0xff);
+    }
+    for (size_t key_bytes: {16U, 32U}) {
+        std::string key;
+        for (size_t i = 0; i < key_bytes; ++i) {
+            key += static_cast<char>(i * 13 + 1);
+        }
+        std::string expected;
+        for (auto const& provider: QPDFCryptoProvider::getRegisteredImpls()) {
+            QPDFCryptoProvider::setDefaultProvider(provider);
+            std::string encrypted;
+            std::string decrypted;
+            double encrypt_time = run_aes(true, key, clear, encrypted);
+            double decrypt_time = run_aes(false, key, encrypted, decrypted);
+            assert(decrypted == clear);
+            if (expected.empty()) {
+                expected = encrypted;
+            }
+            assert(encrypted == expected);
+            auto mb = static_cast<double>(clear.size()) / 1e6;
+            std::cout << provider << " aes-" << (8 * key_bytes)
+                      << ": encrypt: " << (mb / encrypt_time)
+                      << " MB/s, decrypt: " << (mb / decrypt_time) << " MB/s\n";
+        }
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -35,6 +88,11 @@ main(int argc, char* argv[])
     bool static_iv = false;
     bool disable_padding = false;
 
+    if ((argc == 3) && (strcmp(argv[1], "-benchmark") == 0)) {
+        benchmark(QUtil::string_to_uint(argv[2]));
+        return 0;
+    }
+
     for (int i = 1; i < argc; ++i) {
         char* arg = argv[i];
         if ((arg[0] == '-') || (arg[0] == '+')) {
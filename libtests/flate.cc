@@ -2,8 +2,10 @@
 #include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_Flate.hh>
 #include <qpdf/Pl_StdioFile.hh>
+#include <qpdf/Pl_String.hh>
 #include <qpdf/QUtil.hh>
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -79,6 +81,166 @@ run(char const* filename)
     std::cout << "done" << '\n';
 }
 
+static std::string
+deflate(std::string const& data, int jobs)
+{
+    std::string result;
+    Pl_String s("string", nullptr, result);
+    Pl_Flate def("def", &s, Pl_Flate::a_deflate);
+    def.setJobs(jobs);
+    // Write in pieces that are not aligned with blocks.
+    for (size_t i = 0; i < data.size(); i += 100000) {
+        def.write(
+            reinterpret_cast<unsigned char const*>(data.data()) + i,
+            std::min(size_t(100000), data.size() - i));
+    }
+    def.finish();
+    return result;
+}
+
+static std::string
+inflate(std::string const& data)
+{
+    std::string result;
+    Pl_String s("string", nullptr, result);
+    Pl_Flate inf("inf", &s, Pl_Flate::a_inflate);
+    inf.write(reinterpret_cast<unsigned char const*>(data.data()), data.size());
+    inf.finish();
+    return result;
+}
+
+static unsigned long
+adler32(std::string const& data)
+{
+    unsigned long a = 1;
+    unsigned long b = 0;
+    for (auto ch: data) {
+        a = (a + static_cast<unsigned char>(ch)) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static std::string
+make_data(size_t size)
+{
+    std::string data;
+    for (int i = 0; data.size() < size; ++i) {
+        data += "line " + std::to_string(i) + ": " + std::to_string(i * 7919 % 10007) + "\n";
+    }
+    return data;
+}
+
+static std::string
+try_inflate(std::string const& data)
+{
+    try {
+        return inflate(data);
+    } catch (std::exception& e) {
+        return std::string("exception: ") + e.what();
+    }
+}
+
+void
+run_blocks()
+{
+    auto data = make_data(3 * Pl_Flate::block_size + 12345);
+    std::string small = data.substr(0, 50000);
+    auto regular = deflate(data, 1);
+    auto regular_small = deflate(small, 1);
+
+    Pl_Flate::setBlockThreshold(100000);
+    auto blocks = deflate(data, 1);
+    if (deflate(data, 4) != blocks) {
+        std::cout << "block compression depends on jobs" << '\n';
+    }
+    if (deflate(small, 4) != regular_small) {
+        std::cout << "data below threshold compressed differently" << '\n';
+    }
+    if (blocks == regular) {
+        std::cout << "data above threshold not compressed in blocks" << '\n';
+    }
+    if (((static_cast<unsigned char>(blocks.at(0)) << 8) |
+         static_cast<unsigned char>(blocks.at(1))) %
+            31 !=
+        0) {
+        std::cout << "bad zlib header" << '\n';
+    }
+    unsigned long trailer = 0;
+    for (size_t i = blocks.size() - 4; i < blocks.size(); ++i) {
+        trailer = (trailer << 8) | static_cast<unsigned char>(blocks.at(i));
+    }
+    if (trailer != adler32(data)) {
+        std::cout << "bad adler32 checksum" << '\n';
+    }
+    if (inflate(blocks) != data) {
+        std::cout << "blocks did not inflate to input" << '\n';
+    }
+    Pl_Flate::setBlockThreshold(0);
+    std::cout << "blocks done" << '\n';
+}
+
+void
+run_backends()
+{
+    if (!Pl_Flate::backend_supported(Pl_Flate::b_libdeflate)) {
+        try {
+            Pl_Flate::setBackend(Pl_Flate::b_libdeflate);
+            std::cout << "unsupported backend accepted" << '\n';
+        } catch (std::runtime_error&) {
+        }
+        std::cout << "backends done" << '\n';
+        return;
+    }
+    auto data = make_data(1000000);
+    auto compressed = deflate(data, 1);
+    auto truncated = compressed.substr(0, compressed.size() / 2);
+    auto damaged = compressed;
+    damaged[damaged.size() - 1] ^= 1;
+    auto truncated_zlib = try_inflate(truncated);
+    auto damaged_zlib = try_inflate(damaged);
+
+    Pl_Flate::setBackend(Pl_Flate::b_libdeflate);
+    auto compressed_libdeflate = deflate(data, 1);
+    if (compressed_libdeflate.empty() || inflate(compressed_libdeflate) != data) {
+        std::cout << "libdeflate compression failed" << '\n';
+    }
+    if (inflate(compressed) != data) {
+        std::cout << "libdeflate uncompression failed" << '\n';
+    }
+    // Damaged data is handed to zlib.
+    if (try_inflate(truncated) != truncated_zlib || try_inflate(damaged) != damaged_zlib) {
+        std::cout << "libdeflate handles damaged data differently" << '\n';
+    }
+    // Large input is inflated as it is written rather than collected for libdeflate.
+    Pl_Flate::setCompressionLevel(0);
+    auto large = make_data(3 << 20);
+    auto stored = deflate(large, 1);
+    Pl_Flate::setCompressionLevel(-1);
+    {
+        std::string result;
+        Pl_String s("string", nullptr, result);
+        Pl_Flate inf("inf", &s, Pl_Flate::a_inflate);
+        for (size_t i = 0; i < stored.size(); i += 100000) {
+            inf.write(
+                reinterpret_cast<unsigned char const*>(stored.data()) + i,
+                std::min(size_t(100000), stored.size() - i));
+        }
+        if (result.empty()) {
+            std::cout << "libdeflate collected large input" << '\n';
+        }
+        inf.finish();
+        if (result != large) {
+            std::cout << "large input inflated incorrectly" << '\n';
+        }
+    }
+    Pl_Flate::setBackend(Pl_Flate::b_zlib);
+    if (inflate(compressed_libdeflate) != data) {
+        std::cout << "zlib can't uncompress libdeflate data" << '\n';
+    }
+    std::cout << "backends done" << '\n';
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -90,6 +252,8 @@ main(int argc, char* argv[])
 
     try {
         run(filename);
+        run_blocks();
+        run_backends();
     } catch (std::exception& e) {
         std::cout << e.what() << '\n';
     }
@@ -1,5 +1,14 @@
 #include <qpdf/ObjTable.hh>
 
+#include <qpdf/Buffer.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QPDFWriter.hh>
+#include <qpdf/QUtil.hh>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
 struct Test
 {
     Test() = default;
@@ -48,10 +57,183 @@ class Table: public ObjTable<Test>
     }
 };
 
+template <class M>
+void
+print(M const& map)
+{
+    for (auto const& [og, value]: map) {
+        std::cout << og.unparse(',') << " : " << value << "\n";
+    }
+    std::cout << "size: " << map.size() << ", max id: " << map.max_id() << "\n";
+}
+
+void
+test_obj_gen_map()
+{
+    ObjGenMap<int> map;
+    for (auto [id, gen]: {std::pair{3, 0}, {1, 0}, {2, 0}, {2, 1}, {0, 0}, {-1, 0}, {5, 2}}) {
+        map[QPDFObjGen(id, gen)] = 10 * id + gen;
+    }
+    // Too far beyond the current table to be stored densely.
+    auto& far = map[QPDFObjGen(3000, 0)];
+    far = 30000;
+    print(map);
+
+    std::cout << "contains 2,1: " << map.contains(QPDFObjGen(2, 1)) << "\n";
+    std::cout << "contains 4,0: " << map.contains(QPDFObjGen(4, 0)) << "\n";
+    std::cout << "contains 5,0: " << map.contains(QPDFObjGen(5, 0)) << "\n";
+    std::cout << "find 5,2: " << map.find(QPDFObjGen(5, 2))->second << "\n";
+    std::cout << "find 6,0 is end: " << (map.find(QPDFObjGen(6, 0)) == map.end()) << "\n";
+    auto it = map.find(QPDFObjGen(2, 0));
+    std::cout << "after 2,0: " << (++it)->first.unparse(',') << "\n";
+    std::cout << "upper bound 2,1: " << map.upper_bound(QPDFObjGen(2, 1))->first.unparse(',')
+              << "\n";
+    auto [it2, inserted] = map.try_emplace(QPDFObjGen(3, 0), 99);
+    std::cout << "try_emplace 3,0: " << inserted << " " << it2->second << "\n";
+
+    // Entries inserted during iteration are visited if they come after the current position.
+    for (auto const& [og, value]: map) {
+        std::cout << "visit " << og.unparse(',') << "\n";
+        if (og.getObj() == 3) {
+            map[QPDFObjGen(4, 0)] = 40;
+            map[QPDFObjGen(2, 5)] = 25;
+        }
+    }
+
+    // Growing the table does not invalidate references.
+    for (int i = 6; i < 3100; ++i) {
+        map[QPDFObjGen(i, 0)] = 10 * i;
+    }
+    std::cout << "far: " << far << " " << map[QPDFObjGen(3000, 0)] << "\n";
+    std::cout << "erase 2,0: " << map.erase(QPDFObjGen(2, 0)) << "\n";
+    std::cout << "erase 2,0: " << map.erase(QPDFObjGen(2, 0)) << "\n";
+    std::cout << "erase 3000,0: " << map.erase(QPDFObjGen(3000, 0)) << "\n";
+    for (int i = 6; i < 3100; ++i) {
+        map.erase(QPDFObjGen(i, 0));
+    }
+
+    std::cout << "max id after erase: " << map.max_id() << "\n";
+    map.erase(QPDFObjGen(5, 2));
+    std::cout << "max id after erase 5,2: " << map.max_id() << "\n";
+    map[QPDFObjGen(5, 2)] = 52;
+
+    // Entries inserted into 'others' after the current position are visited, as are entries
+    // inserted into the table after iteration has passed the end of the table and the table has
+    // grown.
+    ObjGenMap<int> small;
+    small[QPDFObjGen(1, 0)] = 10;
+    small[QPDFObjGen(1, 1)] = 11;
+    for (auto const& [og, value]: small) {
+        std::cout << "visit " << og.unparse(',') << "\n";
+        if (og == QPDFObjGen(1, 1)) {
+            small[QPDFObjGen(1, 2)] = 12;
+        } else if (og == QPDFObjGen(1, 2)) {
+            small[QPDFObjGen(1500, 0)] = 15000;
+        }
+    }
+    std::cout << "max id: " << small.max_id() << "\n";
+
+    auto copy = map;
+    map.clear();
+    std::cout << "cleared: " << map.empty() << " " << map.max_id() << "\n";
+    print(copy);
+}
+
+void
+test_obj_id_set()
+{
+    ObjIdSet set;
+    std::cout << "set: " << set.empty() << " " << set.max() << "\n";
+    for (int i: {5, 1000, 3, 5, -1}) {
+        std::cout << "insert " << i << ": " << set.insert(i) << "\n";
+    }
+    std::cout << "set: " << set.size() << " " << set.max() << " " << set.contains(3) << " "
+              << set.contains(4) << " " << set.contains(2000) << "\n";
+    std::cout << "erase 1000: " << set.erase(1000) << " " << set.erase(1000) << "\n";
+    std::cout << "set: " << set.size() << " " << set.max() << "\n";
+    set.clear();
+    std::cout << "set: " << set.empty() << " " << set.max() << "\n";
+}
+
+template <class M>
+double
+lookups(M const& map, int n, int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 1; i <= n; ++i) {
+            sum += map.find(QPDFObjGen(i, 0))->second;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (sum == 0) {
+        std::cout << "unexpected sum\n";
+    }
+    return elapsed.count();
+}
+
+// Compare lookup throughput of std::map and ObjGenMap, and time object lookups in a file with n
+// objects. This is not run by the test suite.
+void
+benchmark(int n)
+{
+    constexpr int rounds = 5;
+    std::map<QPDFObjGen, int> std_map;
+    ObjGenMap<int> obj_gen_map;
+    for (int i = 1; i <= n; ++i) {
+        std_map[QPDFObjGen(i, 0)] = i;
+        obj_gen_map[QPDFObjGen(i, 0)] = i;
+    }
+    auto report = [](char const* what, size_t count, double seconds) {
+        std::cout << what << ": " << (static_cast<double>(count) / seconds / 1e6)
+                  << " million lookups/s\n";
+    };
+    auto total = QIntC::to_size(rounds) * QIntC::to_size(n);
+    report("std::map", total, lookups(std_map, n, rounds));
+    report("ObjGenMap", total, lookups(obj_gen_map, n, rounds));
+
+    QPDF pdf;
+    pdf.emptyPDF();
+    auto kids = pdf.getRoot().getKey("/Pages");
+    auto array = QPDFObjectHandle::newArray();
+    for (int i = 1; i <= n; ++i) {
+        array.appendItem(pdf.makeIndirectObject(QPDFObjectHandle::newInteger(i)));
+    }
+    kids.replaceKey("/QTest", pdf.makeIndirectObject(array));
+    QPDFWriter w(pdf);
+    w.setOutputMemory();
+    w.setObjectStreamMode(qpdf_o_generate);
+    w.write();
+    std::shared_ptr<Buffer> buf(w.getBuffer());
+
+    QPDF in;
+    in.processMemoryFile("benchmark", reinterpret_cast<char*>(buf->getBuffer()), buf->getSize());
+    auto start = std::chrono::steady_clock::now();
+    auto count = QIntC::to_int(in.getAllObjects().size());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "resolve " << count << " objects: " << elapsed.count() << "s\n";
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 1; i <= count; ++i) {
+            in.getObject(i, 0);
+        }
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    report("QPDF::getObject", QIntC::to_size(rounds * count), elapsed.count());
+}
+
 int
-main()
+main(int argc, char* argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        benchmark(argc > 2 ? QUtil::string_to_int(argv[2]) : 1'000'000);
+        return 0;
+    }
+
     Table().test();
+    test_obj_gen_map();
+    test_obj_id_set();
 
     std::cout << "object table tests done\n";
     return 0;
@@ -2,10 +2,12 @@
 
 #include <qpdf/Pl_PNGFilter.hh>
 #include <qpdf/Pl_StdioFile.hh>
+#include <qpdf/Pl_String.hh>
 #include <qpdf/Pl_TIFFPredictor.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QUtil.hh>
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -72,9 +74,121 @@ run(char const* filename,
     std::cout << "done" << '\n';
 }
 
+// Straightforward implementation of PNG decoding as described in the PNG specification
+static std::string
+png_decode(std::string const& data, size_t bytes_per_row, size_t bpp)
+{
+    std::string result;
+    std::string prev(bytes_per_row, '\0');
+    for (size_t row = 0; row + bytes_per_row + 1 <= data.size(); row += bytes_per_row + 1) {
+        std::string cur = data.substr(row + 1, bytes_per_row);
+        for (size_t i = 0; i < bytes_per_row; ++i) {
+            int a = i >= bpp ? static_cast<unsigned char>(cur[i - bpp]) : 0;
+            int b = static_cast<unsigned char>(prev[i]);
+            int c = i >= bpp ? static_cast<unsigned char>(prev[i - bpp]) : 0;
+            int x = static_cast<unsigned char>(cur[i]);
+            switch (data[row]) {
+            case 1:
+                x += a;
+                break;
+            case 2:
+                x += b;
+                break;
+            case 3:
+                x += (a + b) / 2;
+                break;
+            case 4:
+                {
+                    int p = a + b - c;
+                    int pa = std::abs(p - a);
+                    int pb = std::abs(p - b);
+                    int pc = std::abs(p - c);
+                    x += (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+                }
+                break;
+            default:
+                break;
+            }
+            cur[i] = static_cast<char>(x);
+        }
+        result += cur;
+        prev = cur;
+    }
+    return result;
+}
+
+static std::string
+filter(std::string const& data, Pipeline& pl, std::string& out, double& seconds)
+{
+    out.clear();
+    auto start = std::chrono::steady_clock::now();
+    pl.write(reinterpret_cast<unsigned char const*>(data.data()), data.size());
+    pl.finish();
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+// Check the PNG and TIFF predictors for 8-bit samples against straightforward implementations
+// and report their throughput. This is not run by the test suite except with small inputs.
+static void
+benchmark(unsigned int rows)
+{
+    constexpr unsigned int columns = 1024;
+    constexpr int rounds = 5;
+    unsigned int seed = 1;
+    auto random = [&seed]() {
+        seed = seed * 1103515245U + 12345U;
+        return static_cast<char>(seed >> 16);
+    };
+    auto report = [](char const* what, unsigned int spp, size_t bytes, double seconds) {
+        std::cout << what << " " << spp
+                  << " bytes per pixel: " << (static_cast<double>(bytes) / seconds / 1e6)
+                  << " MB/s\n";
+    };
+    for (unsigned int spp: {1U, 2U, 3U, 4U, 6U}) {
+        size_t bytes_per_row = columns * spp;
+        std::string encoded;
+        for (unsigned int row = 0; row < rows; ++row) {
+            encoded += static_cast<char>(row % 5);
+            for (size_t i = 0; i < bytes_per_row; ++i) {
+                encoded += random();
+            }
+        }
+        auto expected = png_decode(encoded, bytes_per_row, spp);
+
+        std::string out;
+        Pl_String sink("sink", nullptr, out);
+        Pl_PNGFilter png_decoder("png", &sink, Pl_PNGFilter::a_decode, columns, spp, 8);
+        Pl_PNGFilter png_encoder("png", &sink, Pl_PNGFilter::a_encode, columns, spp, 8);
+        Pl_TIFFPredictor tiff_decoder("tiff", &sink, Pl_TIFFPredictor::a_decode, columns, spp, 8);
+        Pl_TIFFPredictor tiff_encoder("tiff", &sink, Pl_TIFFPredictor::a_encode, columns, spp, 8);
+        double seconds[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int i = 0; i < rounds; ++i) {
+            assert(filter(encoded, png_decoder, out, seconds[0]) == expected);
+            auto up = filter(expected, png_encoder, out, seconds[1]);
+            assert(up.size() == encoded.size() && png_decode(up, bytes_per_row, spp) == expected);
+            auto tiff = filter(expected, tiff_encoder, out, seconds[2]);
+            for (size_t j = 0; j < tiff.size(); ++j) {
+                auto left = j % bytes_per_row >= spp ? expected[j - spp] : 0;
+                assert(tiff[j] == static_cast<char>(expected[j] - left));
+            }
+            assert(filter(tiff, tiff_decoder, out, seconds[3]) == expected);
+        }
+        auto bytes = rounds * expected.size();
+        report("png decode", spp, bytes, seconds[0]);
+        report("png encode", spp, bytes, seconds[1]);
+        report("tiff encode", spp, bytes, seconds[2]);
+        report("tiff decode", spp, bytes, seconds[3]);
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        benchmark(argc > 2 ? QUtil::string_to_uint(argv[2]) : 1000);
+        return 0;
+    }
     if (argc != 7) {
         std::cerr << "Usage: predictor {png|tiff} {en,de}code filename"
                   << " columns samples-per-pixel bits-per-sample" << '\n';
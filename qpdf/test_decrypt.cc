@@ -0,0 +1,159 @@
+#include <qpdf/Pl_String.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QIntC.hh>
+#include <qpdf/QPDFObjectHandle.hh>
+#include <qpdf/QUtil.hh>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static char const* whoami = nullptr;
+
+static void
+usage()
+{
+    std::cerr << "Usage: " << whoami << " [-benchmark rounds] filename password" << '\n';
+    exit(2);
+}
+
+namespace
+{
+    struct Counts
+    {
+        size_t objects{0};
+        size_t strings{0};
+        size_t string_bytes{0};
+        size_t streams{0};
+        size_t stream_bytes{0};
+        // Sums of the hashes of all strings and of all stream data. Summing makes them independent
+        // of object numbering, so files written from the same input can be compared.
+        uint64_t string_digest{0};
+        uint64_t stream_digest{0};
+    };
+} // namespace
+
+// 64-bit FNV-1a hash
+static uint64_t
+hash(std::string const& data)
+{
+    uint64_t result = 0xcbf29ce484222325ULL;
+    for (char c: data) {
+        result = (result ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+    }
+    return result;
+}
+
+static void
+count_strings(QPDFObjectHandle oh, Counts& counts)
+{
+    if (oh.isString()) {
+        auto const& value = oh.getStringValue();
+        ++counts.strings;
+        counts.string_bytes += value.size();
+        counts.string_digest += hash(value);
+    } else if (oh.isArray()) {
+        for (auto& item: oh.aitems()) {
+            if (!item.isIndirect()) {
+                count_strings(item, counts);
+            }
+        }
+    } else if (oh.isDictionary()) {
+        for (auto& [key, value]: oh.ditems()) {
+            if (!value.isIndirect()) {
+                count_strings(value, counts);
+            }
+        }
+    }
+}
+
+// Read every object of the file, which decrypts all strings, and retrieve the data of every stream.
+static Counts
+decrypt_all(char const* filename, char const* password)
+{
+    Counts counts;
+    QPDF qpdf;
+    qpdf.processFile(filename, password);
+    // The encryption dictionary is not encrypted.
+    auto encrypt = qpdf.getTrailer().getKey("/Encrypt").getObjGen();
+    for (auto& oh: qpdf.getAllObjects()) {
+        if (oh.getObjGen() == encrypt) {
+            continue;
+        }
+        ++counts.objects;
+        if (oh.isStream()) {
+            auto type = oh.getDict().getKey("/Type");
+            if (type.isNameAndEquals("/ObjStm") || type.isNameAndEquals("/XRef")) {
+                // These depend on how the file was written rather than on its contents.
+                --counts.objects;
+                continue;
+            }
+            ++counts.streams;
+            count_strings(oh.getDict(), counts);
+            std::string data;
+            Pl_String pl("data", nullptr, data);
+            oh.pipeStreamData(&pl, 0, qpdf_dl_generalized);
+            counts.stream_bytes += data.size();
+            counts.stream_digest += hash(data);
+        } else {
+            count_strings(oh, counts);
+        }
+    }
+    return counts;
+}
+
+// Time reading and decrypting all objects and streams of a file rounds times. This is not run by
+// the test suite except with small inputs.
+static void
+benchmark(char const* filename, char const* password, int rounds)
+{
+    Counts counts;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        counts = decrypt_all(filename, password);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    auto objects = static_cast<double>(QIntC::to_size(rounds) * counts.objects);
+    auto bytes =
+        static_cast<double>(QIntC::to_size(rounds) * (counts.string_bytes + counts.stream_bytes));
+    std::cout << "decrypted " << counts.objects << " objects " << rounds
+              << " times: " << (objects / elapsed.count()) << " objects/s, "
+              << (bytes / elapsed.count() / 1e6) << " MB/s\n";
+}
+
+int
+main(int argc, char* argv[])
+{
+    whoami = QUtil::getWhoami(argv[0]);
+    int rounds = 0;
+    int arg = 1;
+    if ((argc > 2) && (strcmp(argv[1], "-benchmark") == 0)) {
+        rounds = QUtil::string_to_int(argv[2]);
+        arg = 3;
+    }
+    if (argc != arg + 2) {
+        usage();
+    }
+    char const* filename = argv[arg];
+    char const* password = argv[arg + 1];
+
+    try {
+        if (rounds > 0) {
+            benchmark(filename, password, rounds);
+        } else {
+            auto counts = decrypt_all(filename, password);
+            std::cout << "objects: " << counts.objects << '\n'
+                      << "strings: " << counts.strings << ", " << counts.string_bytes
+                      << " bytes" << '\n'
+                      << "streams: " << counts.streams << ", " << counts.stream_bytes
+                      << " bytes" << '\n'
+                      << "string digest: " << std::hex << counts.string_digest << '\n'
+                      << "stream digest: " << counts.stream_digest << std::dec << '\n';
+        }
+    } catch (std::exception& e) {
+        std::cerr << whoami << ": " << e.what() << '\n';
+        exit(2);
+    }
+    return 0;
+}
@@ -3598,6 +3598,389 @@ test_102(QPDF& pdf, char const* arg2)
     j2.writeQPDF(*q);
 }
 
+static void
+test_103(QPDF& pdf, char const* arg2)
+{
+    // Test bounded object cache. The file has object streams.
+    auto write = [](QPDF& q) {
+        QPDFWriter w(q);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.write();
+        auto b = w.getBufferSharedPointer();
+        return std::string(reinterpret_cast<char*>(b->getBuffer()), b->getSize());
+    };
+    auto unparse = [](std::vector<QPDFObjectHandle> const& objects) {
+        std::string result;
+        for (auto const& oh: objects) {
+            result += oh.unparse() + ": " + oh.unparseResolved() + "\n";
+        }
+        return result;
+    };
+
+    pdf.setObjectCacheLimit(2);
+    auto all = pdf.getAllObjects();
+    auto const original = unparse(all);
+    auto stats = pdf.getObjectCacheStats();
+    // Objects are only released on request or while writing.
+    assert(stats.misses > 0 && stats.evictions == 0);
+    auto root = pdf.getObject(pdf.getRoot().getObjGen());
+    assert(pdf.getObjectCacheStats().hits == stats.hits + 1);
+
+    // Modified objects and objects into which handles are held are not released.
+    root.replaceKey("/QTest", QPDFObjectHandle::newString("modified"));
+    auto pages = root.getKey("/Pages");
+    auto kids = pages.getKey("/Kids");
+    pdf.trimObjectCache();
+    stats = pdf.getObjectCacheStats();
+    assert(stats.evictions > 0);
+    assert(root.getKey("/QTest").getUTF8Value() == "modified");
+    assert(pages.getKey("/Count").getIntValue() == 30);
+    assert(pdf.getObjectCacheStats().misses == stats.misses);
+
+    // Released objects are read again when accessed.
+    root.removeKey("/QTest");
+    assert(unparse(all) == original);
+    assert(pdf.getObjectCacheStats().misses > stats.misses);
+
+    // Writing releases objects and produces the same output as writing without a limit.
+    pdf.trimObjectCache();
+    stats = pdf.getObjectCacheStats();
+    QPDF other;
+    other.processFile(pdf.getFilename().c_str());
+    assert(write(pdf) == write(other));
+    assert(pdf.getObjectCacheStats().evictions > stats.evictions);
+    assert(unparse(all) == original);
+    pdf.setObjectCacheLimit(0);
+}
+
+static void
+test_104(QPDF& pdf, char const* arg2)
+{
+    // Test parsing the members of object streams on demand. The file has object streams.
+    auto unparse = [](QPDF& q) {
+        std::string result;
+        for (auto const& oh: q.getAllObjects()) {
+            result += oh.unparse() + ": " + oh.unparseResolved() + "\n";
+        }
+        return result;
+    };
+
+    QPDF lazy;
+    lazy.setObjectStreamCacheLimit(1);
+    lazy.setObjectCacheLimit(1);
+    lazy.processFile(pdf.getFilename().c_str());
+    assert(pdf.getRoot().getKey("/Pages").getKey("/Count").getIntValue() == 30);
+    assert(lazy.getRoot().getKey("/Pages").getKey("/Count").getIntValue() == 30);
+    auto misses = lazy.getObjectCacheStats().misses;
+    assert(misses > 0 && misses < pdf.getObjectCacheStats().misses);
+
+    // Accessing all objects gives the same result as parsing whole object streams.
+    assert(unparse(lazy) == unparse(pdf));
+    assert(lazy.getObjectCacheStats().misses > misses);
+
+    // Objects released by the bounded object cache are parsed again individually.
+    lazy.trimObjectCache();
+    assert(lazy.getObjectCacheStats().evictions > 0);
+    misses = lazy.getObjectCacheStats().misses;
+    assert(unparse(lazy) == unparse(pdf));
+    assert(lazy.getObjectCacheStats().misses > misses);
+}
+
+static void
+test_105(QPDF& pdf, char const* arg2)
+{
+    // Test copying unchanged stream data from the input file.
+    auto write = [&pdf](std::function<void(QPDFWriter&)> f) {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.setStreamDataMode(qpdf_s_preserve);
+        f(w);
+        w.write();
+        return w.getCopiedStreamBytes();
+    };
+
+    size_t expected = 0;
+    QPDFObjectHandle first;
+    for (auto& oh: pdf.getAllObjects()) {
+        if (oh.isStream()) {
+            expected += oh.getRawStreamData()->getSize();
+            if (!first && oh.getDict().getKey("/Subtype").isNameAndEquals("/Image")) {
+                first = oh;
+            }
+        }
+    }
+    assert(expected > 0 && first);
+    assert(write([](QPDFWriter&) {}) == expected);
+    // For linearized files, only the final pass is counted.
+    assert(write([](QPDFWriter& w) { w.setLinearization(true); }) == expected);
+    // Encrypted output can't be copied.
+    assert(write([](QPDFWriter& w) {
+               w.setR3EncryptionParametersInsecure(
+                   "", "o", true, true, true, true, true, true, qpdf_r3p_full);
+           }) == 0);
+
+    // Replaced stream data is not copied.
+    auto length = first.getRawStreamData()->getSize();
+    first.replaceStreamData(
+        first.getRawStreamData(),
+        first.getDict().getKey("/Filter"),
+        first.getDict().getKey("/DecodeParms"));
+    assert(write([](QPDFWriter&) {}) == expected - length);
+}
+
+static void
+test_106(QPDF& pdf, char const* arg2)
+{
+    // Test writing incremental updates.
+    auto original = QUtil::read_file_into_string(pdf.getFilename().c_str());
+    auto write = [&pdf]() {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.setIncrementalUpdate(true);
+        w.write();
+        auto buf = w.getBufferSharedPointer();
+        return std::string(reinterpret_cast<char*>(buf->getBuffer()), buf->getSize());
+    };
+    auto reread = [](std::string const& data, QPDF& out) {
+        out.processMemoryFile("incremental update", data.data(), data.size());
+        for (auto& oh: out.getAllObjects()) {
+            if (oh.isStream()) {
+                oh.getStreamData();
+            }
+        }
+        assert(!out.anyWarnings());
+        assert(out.getTrailer().getKey("/Prev").isInteger());
+    };
+
+    // Without changes, only a new cross-reference section and trailer are appended.
+    auto unchanged = write();
+    assert(unchanged.starts_with(original));
+    assert(unchanged.size() - original.size() < 500);
+    {
+        QPDF out;
+        reread(unchanged, out);
+        assert(out.getObjectCount() >= pdf.getObjectCount());
+    }
+
+    // Modify an existing page, replace its content stream data, and add a new object.
+    auto page = pdf.getAllPages().at(0);
+    page.replaceKey("/Rotate", QPDFObjectHandle::newInteger(90));
+    auto contents = page.getKey("/Contents");
+    if (contents.isArray()) {
+        contents = contents.getArrayItem(0);
+    }
+    contents.replaceStreamData(
+        "BT /F1 24 Tf 72 720 Td (incremental) Tj ET\n",
+        QPDFObjectHandle::newNull(),
+        QPDFObjectHandle::newNull());
+    auto info = pdf.makeIndirectObject(QPDFObjectHandle::parse("<< /Title (incremental) >>"));
+    pdf.getTrailer().replaceKey("/Info", info);
+
+    // Change other objects through each of the remaining ways of changing them. Each change is
+    // made to a different object so that every change has to be found on its own. The comparison
+    // of all objects below checks that none of them is lost.
+    std::vector<QPDFObjectHandle> dicts;
+    std::vector<QPDFObjectHandle> arrays;
+    std::vector<QPDFObjectHandle> streams;
+    for (auto& oh: pdf.getAllObjects()) {
+        if (oh.isPageObject() || oh.isPagesObject() || oh.getObjGen() == page.getObjGen() ||
+            oh.getObjGen() == pdf.getRoot().getObjGen() || oh.getObjGen() == info.getObjGen() ||
+            oh.getObjGen() == contents.getObjGen()) {
+            continue;
+        }
+        if (oh.isStream()) {
+            if (!oh.isStreamOfType("/XRef") && !oh.isStreamOfType("/ObjStm")) {
+                streams.emplace_back(oh);
+            }
+        } else if (oh.isDictionary() && !oh.getKeys().empty()) {
+            dicts.emplace_back(oh);
+        } else if (oh.isArray() && oh.getArrayNItems() > 0) {
+            arrays.emplace_back(oh);
+        }
+    }
+    if (dicts.size() > 0) {
+        dicts.at(0).removeKey(*dicts.at(0).getKeys().rbegin());
+    }
+    if (dicts.size() > 1) {
+        auto copy = dicts.at(1).shallowCopy();
+        copy.replaceKey("/QTestReplaced", QPDFObjectHandle::newBool(true));
+        pdf.replaceObject(dicts.at(1).getObjGen(), copy);
+    }
+    if (arrays.size() > 0) {
+        arrays.at(0).appendItem(QPDFObjectHandle::newName("/QTestAppended"));
+    }
+    if (arrays.size() > 1) {
+        arrays.at(1).eraseItem(0);
+    }
+    if (arrays.size() > 2) {
+        arrays.at(2).setArrayItem(0, QPDFObjectHandle::newName("/QTestSet"));
+    }
+    if (!streams.empty()) {
+        // A direct object within the object changes.
+        streams.at(0).getDict().replaceKey("/QTestStream", QPDFObjectHandle::newBool(true));
+    }
+
+    auto updated = write();
+    assert(updated.starts_with(original));
+    assert(updated.size() - original.size() < 1500);
+    QPDF out;
+    reread(updated, out);
+    auto out_page = out.getAllPages().at(0);
+    assert(out_page.getKey("/Rotate").getIntValue() == 90);
+    assert(out.getTrailer().getKey("/Info").getKey("/Title").getUTF8Value() == "incremental");
+    assert(out_page.getObjGen() == page.getObjGen());
+    assert(out.getObject(info.getObjGen()).isDictionary());
+
+    // All objects of the modified document are present in the updated file.
+    auto data = [](QPDFObjectHandle& stream) {
+        auto buf = stream.getStreamData(qpdf_dl_all);
+        return std::string(reinterpret_cast<char*>(buf->getBuffer()), buf->getSize());
+    };
+    for (auto& oh: pdf.getAllObjects()) {
+        auto out_oh = out.getObject(oh.getObjGen());
+        if (oh.isStream()) {
+            assert(out_oh.isStream() && data(oh) == data(out_oh));
+        } else {
+            assert(oh.unparseResolved() == out_oh.unparseResolved());
+        }
+    }
+
+    // Incremental updates can't be encrypted or linearized.
+    for (int i = 0; i < 2; ++i) {
+        QPDFWriter w2(pdf);
+        w2.setOutputMemory();
+        w2.setIncrementalUpdate(true);
+        if (i == 0) {
+            w2.setR3EncryptionParametersInsecure(
+                "", "o", true, true, true, true, true, true, qpdf_r3p_full);
+        } else {
+            w2.setLinearization(true);
+        }
+        try {
+            w2.write();
+            assert(false);
+        } catch (std::runtime_error&) {
+        }
+    }
+}
+
+static void
+test_107(QPDF& pdf, char const* arg2)
+{
+    // Test reconstructing the cross-reference table of a file that is large enough to be scanned in
+    // several windows and ranges.
+    std::string data =
+        "%PDF-1.3\n1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n"
+        "2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n"
+        "3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] >>\nendobj\n";
+    std::map<int, std::string> contents;
+    unsigned int seed = 107;
+    auto random = [&seed](unsigned int n) {
+        seed = seed * 1103515245U + 12345U;
+        return (seed >> 8) % n;
+    };
+    int id = 4;
+    while (data.size() < 40'000'000) {
+        std::string content;
+        if (id % 2) {
+            // Pseudo-random binary data
+            for (auto n = 1000 + random(60000); n > 0; --n) {
+                content += static_cast<char>(random(256));
+            }
+        } else {
+            // Content stream with various line endings, strings and hex strings spanning lines,
+            // comments, and lines starting with numbers.
+            for (auto n = 10 + random(500); n > 0; --n) {
+                auto eol = random(3) == 0 ? "\r\n" : random(2) ? "\n" : "\r";
+                switch (random(5)) {
+                case 0:
+                    content += "(a string" + std::string(eol) + "spanning lines) Tj" + eol;
+                    break;
+                case 1:
+                    content += "<48656c6c6f" + std::string(eol) + "20776f726c64> Tj" + eol;
+                    break;
+                case 2:
+                    content += "% comment" + std::string(eol);
+                    break;
+                default:
+                    content += "  " + std::to_string(n) + " 0 Td /F1 12 Tf" + eol;
+                    break;
+                }
+            }
+        }
+        data += std::to_string(id) + " 0 obj\n<< /Length " + std::to_string(content.size()) +
+            " >>\nstream\n" + content + "\nendstream\nendobj\n";
+        contents[id] = std::move(content);
+        ++id;
+    }
+    // The cross-reference table is missing and startxref points to the wrong place.
+    data += "trailer << /Size " + std::to_string(id) + " /Root 1 0 R >>\nstartxref\n12\n%%EOF\n";
+
+    QPDF recovered;
+    recovered.setSuppressWarnings(true);
+    recovered.processMemoryFile("large damaged file", data.data(), data.size());
+    assert(recovered.anyWarnings());
+    assert(recovered.getAllPages().size() == 1);
+    for (auto const& [i, content]: contents) {
+        auto stream = recovered.getObject(i, 0);
+        assert(stream.isStream());
+        auto buf = stream.getRawStreamData();
+        assert(std::string(reinterpret_cast<char*>(buf->getBuffer()), buf->getSize()) == content);
+    }
+}
+
+static void
+test_108(QPDF& pdf, char const* arg2)
+{
+    // Test keeping encoded stream data between linearization passes in memory and in a temporary
+    // file.
+    auto write = [&pdf](size_t limit) {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.setLinearization(true);
+        w.setRecompressFlate(true);
+        w.setLinearizationMemoryLimit(limit);
+        w.write();
+        auto b = w.getBufferSharedPointer();
+        return std::string(reinterpret_cast<char*>(b->getBuffer()), b->getSize());
+    };
+    auto const in_memory = write(1 << 28);
+    assert(write(0) == in_memory);
+    assert(write(100'000) == in_memory);
+}
+
+static void
+test_109(QPDF& pdf, char const* arg2)
+{
+    // Test finding pages through the linearization hint tables. Look up all pages before reading
+    // the pages tree, then compare with the pages from the pages tree. With arg2 "inherit", give
+    // the root of the pages tree an inheritable attribute first, so that no page can be used.
+    if (arg2 && strcmp(arg2, "inherit") == 0) {
+        pdf.getRoot().getKey("/Pages").replaceKey("/Rotate", QPDFObjectHandle::newInteger(90));
+    }
+    auto npages = pdf.getLinearizedPageCount();
+    std::vector<QPDFObjectHandle> hinted;
+    for (size_t i = 0; i < npages; ++i) {
+        hinted.emplace_back(pdf.getLinearizedPage(i));
+    }
+    assert(pdf.getLinearizedPage(npages).isNull());
+    assert(!pdf.everCalledGetAllPages());
+    std::cout << "pages from hints: " << npages << '\n';
+    auto const& pages = pdf.getAllPages();
+    for (size_t i = 0; i < npages; ++i) {
+        if (hinted.at(i).isNull()) {
+            std::cout << "page " << i << ": not found\n";
+        } else {
+            assert(hinted.at(i).isSameObjectAs(pages.at(i)));
+            std::cout << "page " << i << ": " << hinted.at(i).getObjGen().unparse(' ') << '\n';
+        }
+    }
+}
+
 void
 runtest(int n, char const* filename1, char const* arg2)
 {
@@ -3699,7 +4082,8 @@ runtest(int n, char const* filename1, char const* arg2)
         {85, test_85},   {86, test_86},   {87, test_87},  {88, test_88}, {89, test_89},
         {90, test_90},   {91, test_91},   {92, test_92},  {93, test_93}, {94, test_94},
         {95, test_95},   {96, test_96},   {97, test_97},  {98, test_98}, {99, test_99},
-        {100, test_100}, {101, test_101}, {102, test_102}};
+        {100, test_100}, {101, test_101}, {102, test_102}, {103, test_103}, {104, test_104},
+        {105, test_105}, {106, test_106}, {107, test_107}, {108, test_108}, {109, test_109}};
 
     auto fn = test_functions.find(n);
     if (fn == test_functions.end()) {
@@ -6,17 +6,20 @@
 #include <qpdf/QPDFPageDocumentHelper.hh>
 #include <qpdf/QPDFTokenizer.hh>
 #include <qpdf/QUtil.hh>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 static char const* whoami = nullptr;
 
 void
 usage()
 {
-    std::cerr << "Usage: " << whoami << " [-maxlen len | -no-ignorable] filename" << '\n';
+    std::cerr << "Usage: " << whoami << " [-maxlen len | -no-ignorable] filename" << '\n'
+              << "       " << whoami << " -benchmark rounds [-no-ignorable] filename" << '\n';
     exit(2);
 }
 
@@ -222,6 +225,52 @@ process(char const* filename, bool include_ignorable, size_t max_len)
     }
 }
 
+// Time tokenizing the content streams of all pages of a file rounds times. This is not run by the
+// test suite except with small inputs.
+static void
+benchmark(char const* filename, bool include_ignorable, int rounds)
+{
+    QPDF qpdf;
+    qpdf.processFile(filename);
+    std::vector<std::shared_ptr<Buffer>> contents;
+    for (auto& page: QPDFPageDocumentHelper(qpdf).getAllPages()) {
+        Pl_Buffer plb("buffer");
+        page.pipeContents(&plb);
+        contents.emplace_back(plb.getBufferSharedPointer());
+    }
+
+    size_t bytes = 0;
+    size_t tokens = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        for (auto& content: contents) {
+            auto is = std::make_shared<BufferInputSource>("content data", content.get());
+            QPDFTokenizer tokenizer;
+            tokenizer.allowEOF();
+            if (include_ignorable) {
+                tokenizer.includeIgnorable();
+            }
+            while (true) {
+                auto token = tokenizer.readToken(is, "benchmark", true);
+                if (token.getType() == QPDFTokenizer::tt_eof) {
+                    break;
+                }
+                ++tokens;
+                if (token.isWord("ID")) {
+                    char ch;
+                    is->read(&ch, 1);
+                    tokenizer.expectInlineImage(is);
+                }
+            }
+            bytes += content->getSize();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "tokenized " << bytes << " bytes, " << tokens << " tokens: "
+              << (static_cast<double>(bytes) / elapsed.count() / 1e6) << " MB/s, "
+              << (static_cast<double>(tokens) / elapsed.count() / 1e6) << " million tokens/s\n";
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -235,6 +284,7 @@ main(int argc, char* argv[])
     char const* filename = nullptr;
     size_t max_len = 0;
     bool include_ignorable = true;
+    int rounds = 0;
     for (int i = 1; i < argc; ++i) {
         if (argv[i][0] == '-') {
             if (strcmp(argv[i], "-maxlen") == 0) {
@@ -242,6 +292,11 @@ main(int argc, char* argv[])
                     usage();
                 }
                 max_len = QUtil::string_to_uint(argv[i]);
+            } else if (strcmp(argv[i], "-benchmark") == 0) {
+                if (++i >= argc) {
+                    usage();
+                }
+                rounds = QUtil::string_to_int(argv[i]);
             } else if (strcmp(argv[i], "-no-ignorable") == 0) {
                 include_ignorable = false;
             } else {
@@ -258,7 +313,11 @@ main(int argc, char* argv[])
     }
 
     try {
-        process(filename, include_ignorable, max_len);
+        if (rounds > 0) {
+            benchmark(filename, include_ignorable, rounds);
+        } else {
+            process(filename, include_ignorable, max_len);
+        }
     } catch (std::exception& e) {
         std::cerr << whoami << ": exception: " << e.what();
         exit(2);